@@ -1,12 +1,28 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "desktop/tree/container.h"
 
 #include "util/list.h"
 
+// Max amount of outputs that can be configured.
+#define E_CONFIG_MAX_OUTPUTS 16
+// Max length of output names, including null-terminator.
+#define E_CONFIG_OUTPUT_NAME_MAX 64
+
+struct e_output_config
+{
+    // name of output this applies to, for example: DP-1
+    char name[E_CONFIG_OUTPUT_NAME_MAX];
+
+    // scale of output, may be fractional
+    // default: 1.0
+    float scale;
+};
+
 struct e_keyboard_config
 {
     //TODO: keymap configuration
@@ -30,9 +46,49 @@ struct e_config
 
     struct e_keyboard_config keyboard;
 
+    // configured outputs, outputs not in here use defaults
+    struct e_output_config outputs[E_CONFIG_MAX_OUTPUTS];
+    int output_count;
+
     // whether xwayland should start up for the first time when required or immediately
     // default: true
     bool xwayland_lazy;
+
+    // max amount of title & app id updates per second sent to foreign toplevel clients per toplevel, 0 is unlimited
+    // state changes like activated & fullscreen are never limited
+    // default: 0
+    int32_t foreign_toplevel_max_rate_hz;
+
+    // amount of frame callbacks per second sent to views that aren't visible, 0 sends none
+    // default: 1 hz
+    int32_t hidden_view_frame_rate_hz;
+
+    // time cursor has to rest on a surface before keyboard focus follows it, 0 only waits until all pending input is handled
+    // default: 0 ms
+    int32_t hover_focus_delay_ms;
+
+    // soft limits per client, 0 is unlimited
+    // clients exceeding them are logged once, and disconnected if kill is set
+    struct
+    {
+        // default: 0 MiB
+        int32_t buffer_memory_mb;
+        // default: 0
+        int32_t surfaces;
+        // default: false
+        bool kill;
+    } client_limits;
+
+    // config file contents this config was parsed from, mapped into memory and tokenized in place
+    // keybind commands point into this, so it lives as long as the keybinds do
+    struct
+    {
+        // NULL if no config file was parsed
+        char* data;
+        size_t size;
+        // whether data is a file mapping or a heap copy
+        bool mapped;
+    } source;
 };
 
 // Inits to a default config.
@@ -40,5 +96,16 @@ void e_config_init(struct e_config* config);
 
 void e_config_fini(struct e_config* config);
 
-//TODO: implement e_config_parse_config_file
-//bool e_config_parse_config_file(char* file_path, struct e_config* out);
+// Parses config file at file_path into out, out must already be inited.
+// Options not set inside the file keep their current value in out.
+// Returns true on success, false on fail.
+bool e_config_parse_config_file(const char* file_path, struct e_config* out);
+
+// Returns config of output with name, NULL if output isn't configured.
+struct e_output_config* e_config_get_output(struct e_config* config, const char* name);
+
+// Returns true if both configs have the same keybinds in the same order.
+bool e_config_keybinds_equal(struct e_config* a, struct e_config* b);
+
+// Swaps keybinds and the source they point into between both configs.
+void e_config_swap_keybinds(struct e_config* a, struct e_config* b);
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <wayland-server-core.h>
+
+struct e_server;
+
+// Watches the config file for changes, and applies only changed options to the server on reload.
+struct e_config_watch
+{
+    struct e_server* server;
+
+    // full path to config file
+    char* path;
+    // name of config file inside its directory, points into path
+    const char* file_name;
+
+    int inotify_fd;
+    struct wl_event_source* event_source;
+};
+
+// Starts watching config file at path, reloading server's config when it changes.
+// Returns NULL on fail.
+struct e_config_watch* e_config_watch_create(struct e_server* server, const char* path);
+
+void e_config_watch_destroy(struct e_config_watch* watch);
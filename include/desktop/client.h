@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include <sys/types.h>
+
+#include <wayland-server-core.h>
+#include <wayland-util.h>
+
+#include <wlr/types/wlr_compositor.h>
+
+struct e_server;
+
+// Resources and compositor time used by a connected wayland client, to find clients that use the most.
+// Xwayland is a single client, so all X11 applications are counted together.
+struct e_client
+{
+    struct e_server* server;
+
+    struct wl_client* wl_client;
+    pid_t pid;
+
+    int surfaces;
+    int popups;
+    int views;
+
+    // Estimated size of buffers attached to client's surfaces, in bytes.
+    uint64_t buffer_bytes;
+
+    // Commits since client stats were last logged.
+    uint64_t commits;
+    // Time spent in compositor handlers for client since client stats were last logged.
+    double handler_ms;
+
+    // Client was warned about exceeding soft limits.
+    bool over_limit;
+    // Client was disconnected for exceeding soft limits.
+    bool killed;
+
+    struct wl_listener destroy;
+
+    struct wl_list link; //e_server::clients::list
+};
+
+// Returns client tracking wayland client.
+// Returns NULL if wayland client isn't tracked or is being destroyed.
+struct e_client* e_client_from_wl_client(struct wl_client* wl_client);
+
+// Returns client owning surface.
+// Returns NULL if client isn't tracked or is being destroyed.
+struct e_client* e_client_from_surface(struct wlr_surface* surface);
+
+// Adds time from start until now to time spent handling client.
+// Client is allowed to be NULL.
+void e_client_add_handler_time(struct e_client* client, const struct timespec* start);
+
+// Logs resource usage of all clients, sorted by buffer memory, and resets their rates.
+void e_server_log_clients(struct e_server* server);
+
+// Init tracking of client resources.
+bool e_server_init_clients(struct e_server* server);
+void e_server_fini_clients(struct e_server* server);
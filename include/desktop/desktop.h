@@ -17,6 +17,7 @@ struct e_output;
 struct e_seat;
 
 struct e_container;
+struct e_workspace;
 struct e_view_container; //TODO: remove, only use e_container here
 struct e_layer_surface;
 
@@ -56,6 +57,10 @@ void e_desktop_set_focus_layer_surface(struct e_server* server, struct e_layer_s
 // Returns NULL if no view container has focus.
 struct e_view_container* e_desktop_focused_view_container(struct e_server* server);
 
+// Sets desktop's current seat's focus to most recently focused view container of workspace.
+// Clears focus if workspace has no view containers.
+void e_desktop_focus_workspace(struct e_server* server, struct e_workspace* workspace);
+
 /* interactive */
 
 // Starts an interactive container resize action.
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <time.h>
 
 #include <wayland-server-core.h>
 
@@ -51,6 +52,35 @@ struct e_foreign_toplevel
 {
     struct e_wlr_foreign_toplevel wlr;
     struct e_ext_foreign_toplevel ext;
+
+    // Changes waiting to be sent, coalesced until event loop is idle.
+    // Title & app id are read from ext state.
+    struct
+    {
+        bool title, app_id;
+        bool activated, fullscreen;
+
+        bool activated_value, fullscreen_value;
+    } pending;
+
+    // What clients were last sent, to drop duplicate updates.
+    struct
+    {
+        // May be NULL.
+        char* title;
+        // May be NULL.
+        char* app_id;
+
+        bool activated, fullscreen;
+
+        // Time title or app id were last sent.
+        struct timespec metadata_time;
+    } sent;
+
+    // Sends pending changes, NULL if not scheduled.
+    struct wl_event_source* flush_idle;
+    // Sends rate limited title & app id changes, NULL if not created yet.
+    struct wl_event_source* flush_timer;
 };
 
 // Should be done on view map.
@@ -62,9 +92,12 @@ void e_foreign_toplevel_output_leave(struct e_foreign_toplevel* foreign_toplevel
 
 //TODO: set_parent, set_maximized, set_minimized
 
-// title may be NULL.
+// Title, app id & state changes are coalesced and sent once event loop is idle.
+// Title & app id updates can be limited further by config's foreign_toplevel_max_rate_hz.
+
+// title may be NULL, must stay valid until next title change or until foreign toplevel is destroyed.
 void e_foreign_toplevel_set_title(struct e_foreign_toplevel* foreign_toplevel, const char* title);
-// app_id may be NULL.
+// app_id may be NULL, must stay valid until next app id change or until foreign toplevel is destroyed.
 void e_foreign_toplevel_set_app_id(struct e_foreign_toplevel* foreign_toplevel, const char* app_id);
 void e_foreign_toplevel_set_activated(struct e_foreign_toplevel* foreign_toplevel, bool activated);
 void e_foreign_toplevel_set_fullscreen(struct e_foreign_toplevel* foreign_toplevel, bool fullscreen);
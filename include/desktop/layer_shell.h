@@ -42,7 +42,7 @@ struct e_layer_surface
     // Layer surface's output was destroyed.
     struct wl_listener output_destroy;
 
-    struct wl_list link; //e_output::layer_surfaces
+    struct wl_list link; //e_output::layer_surfaces[layer]
 };
 
 // Temporary surface for layer surfaces.
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
 #include <wayland-server-core.h>
 #include <wayland-util.h>
 
@@ -16,6 +20,14 @@ struct e_server;
 struct e_cosmic_workspace_group;
 struct e_ext_workspace_group;
 
+struct e_workspace;
+
+// Amount of workspace slots per output, workspaces are created on demand.
+#define E_OUTPUT_WORKSPACE_SLOTS 5
+
+// Amount of layer shell layers, see enum zwlr_layer_shell_v1_layer.
+#define E_OUTPUT_LAYERS 4
+
 //see: wlr-layer-shell-unstable-v1-protocol.h @ enum zwlr_layer_shell_v1_layer
 struct e_output_desktop_layers
 {
@@ -52,8 +64,38 @@ struct e_output
         struct e_cosmic_workspace_group* cosmic_handle;
         struct e_ext_workspace_group* ext_handle;
 
-        struct e_list workspaces; //struct e_workspace*
+        // Workspaces by slot index, NULL if not created yet.
+        // Created when first displayed or targeted, destroyed again once empty & inactive.
+        struct e_workspace* workspaces[E_OUTPUT_WORKSPACE_SLOTS];
+
+        // Destroys empty inactive workspaces, NULL if not scheduled.
+        struct wl_event_source* reclaim_idle;
+        // Arranges inactive workspaces in the background, NULL if not scheduled.
+        struct wl_event_source* arrange_idle;
     } workspace_group;
+
+    // Presented frames with cursor on a hardware plane or composited by the renderer.
+    struct
+    {
+        uint64_t hardware_frames;
+        uint64_t composited_frames;
+        // Cursor was on a hardware plane in the last frame it was displayed.
+        bool hardware;
+    } cursor_stats;
+
+    // Layer surface changes that rearranged the active workspace, or were skipped because its area stayed the same.
+    struct
+    {
+        uint64_t relayouts;
+        uint64_t skips;
+    } layer_arrange_stats;
+
+    // Time output started displaying a different workspace, for measuring switch to frame latency.
+    struct timespec workspace_switch_time;
+    bool workspace_switch_pending;
+
+    // Output management configuration being applied changes this output, so it has to be arranged.
+    bool config_changed;
     
     // Workspace that output is currently displaying, may be NULL.
     struct e_workspace* active_workspace;
@@ -62,7 +104,8 @@ struct e_output
     struct e_output_desktop_layers layers;
     struct wlr_scene_tree* layer_popup_tree;
 
-    struct wl_list layer_surfaces; //struct e_layer_surface*
+    // Mapped layer surfaces by layer, indexed by enum zwlr_layer_shell_v1_layer.
+    struct wl_list layer_surfaces[E_OUTPUT_LAYERS]; //struct e_layer_surface*
 
     // Output has a new frame ready
     struct wl_listener frame;
@@ -82,11 +125,35 @@ struct e_output* e_output_create(struct wlr_output* output);
 // Returns NULL if none.
 struct e_layer_surface* e_output_get_exclusive_topmost_layer_surface(struct e_output* output);
 
+// Returns workspace in slot index of output, creating it if it doesn't exist yet.
+// Returns NULL on fail.
+struct e_workspace* e_output_get_workspace(struct e_output* output, int index);
+
+// Returns slot index of workspace in output.
+// Returns -1 if not found.
+int e_output_get_workspace_index(struct e_output* output, struct e_workspace* workspace);
+
+// Schedules destroying output's empty & inactive workspaces once event loop is idle.
+void e_output_schedule_workspace_reclaim(struct e_output* output);
+
+// Schedules arranging output's inactive workspaces in the background, so displaying them doesn't have to.
+void e_output_schedule_inactive_workspaces_arrange(struct e_output* output);
+
 // Display given workspace.
 // Given workspace must be inactive, but is allowed to be NULL.
 bool e_output_display_workspace(struct e_output* output, struct e_workspace* workspace);
 
+// Places enabled output at x, y in layout, or removes disabled output from layout.
+// Returns true on success, false on fail.
+bool e_output_update_layout(struct e_output* output, bool enabled, int x, int y);
+
+// Applies output's configuration in server's config, or defaults if it isn't configured.
+void e_output_apply_config(struct e_output* output);
+
 void e_output_arrange(struct e_output* output);
 
+// Arranges layer surfaces of output, only rearranging its active workspace if the area left for it changed.
+void e_output_arrange_layers(struct e_output* output);
+
 // Destroy the output.
 void e_output_destroy(struct e_output* output);
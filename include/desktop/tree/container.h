@@ -101,6 +101,8 @@ struct e_view_container
     // Pending area should match current area when no configures are pending.
     struct wlr_box view_current, view_pending;
 
+    struct wl_list focus_link; //e_workspace::focus_stack
+
     struct e_container base;
 
     struct wl_listener map;
@@ -142,6 +144,9 @@ void e_container_set_workspace(struct e_container* container, struct e_workspace
 // Set container fullscreen state.
 void e_container_set_fullscreen(struct e_container* container, bool fullscreen);
 
+// Set suspended state of views inside container.
+void e_container_set_suspended(struct e_container* container, bool suspended);
+
 // Sets the parent of a container.
 // Parent may be NULL.
 // Returns true on success, false on fail.
@@ -224,3 +229,7 @@ struct e_view_container* e_view_container_create(struct e_server* server, struct
 // Finds the view container which has this surface as its view's main surface.
 // Returns NULL on fail.
 struct e_view_container* e_view_container_try_from_surface(struct e_server* server, struct wlr_surface* surface);
+
+// Moves view container's mapped view to its pending position immediately if its size isn't changing, as moving doesn't need a commit.
+// Returns true if view was moved.
+bool e_view_container_apply_pending_position(struct e_view_container* view_container);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include <wayland-server-core.h>
 #include <wayland-util.h>
@@ -13,6 +14,8 @@
 
 #include "util/list.h"
 
+#include "protocols/workspace-info.h"
+
 struct e_output;
 struct e_view;
 
@@ -38,6 +41,9 @@ struct e_workspace
 
     struct wlr_box full_area;
     struct wlr_box tiled_area;
+
+    // Containers were added, removed or moved since workspace was last arranged.
+    bool dirty;
     
     // Container currently in fullscreen mode.
     struct e_container* fullscreen_container;
@@ -47,6 +53,13 @@ struct e_workspace
 
     struct e_list floating_containers; //struct e_container*
 
+    // View containers in workspace, most recently focused first.
+    // There is only a single seat, so it is the seat's focus history for this workspace.
+    struct wl_list focus_stack; //struct e_view_container*
+
+    // State shared by the workspace protocol handles.
+    struct e_workspace_info info;
+
     struct e_cosmic_workspace* cosmic_handle;
 
     struct wl_listener cosmic_request_activate;
@@ -63,6 +76,12 @@ struct e_workspace* e_workspace_create(struct e_output* output);
 // Set name of workspace.
 void e_workspace_set_name(struct e_workspace* workspace, const char* name);
 
+// Set coordinates of workspace within its output's workspace group.
+void e_workspace_set_coords(struct e_workspace* workspace, uint32_t x);
+
+// Returns true if workspace has no containers.
+bool e_workspace_is_empty(struct e_workspace* workspace);
+
 // Enable/disable workspace trees.
 void e_workspace_set_activated(struct e_workspace* workspace, bool activated);
 
@@ -72,6 +91,9 @@ void e_workspace_arrange(struct e_workspace* workspace, struct wlr_box full_area
 // Rearrange workspace within its current area.
 void e_workspace_rearrange(struct e_workspace* workspace);
 
+// Marks workspace's containers as changed, so it is arranged before it is displayed if nothing else arranges it.
+void e_workspace_mark_dirty(struct e_workspace* workspace);
+
 // Update visibility of workspace trees.
 void e_workspace_update_tree_visibility(struct e_workspace* workspace);
 
@@ -88,6 +110,14 @@ void e_workspace_add_floating_container(struct e_workspace* workspace, struct e_
 // Container is allowed to be NULL.
 void e_workspace_change_fullscreen_container(struct e_workspace* workspace, struct e_container* container);
 
+// Moves all containers of workspace to target, fullscreen containers stop being fullscreen.
+// Target workspace must be arranged after.
+void e_workspace_move_containers(struct e_workspace* workspace, struct e_workspace* target);
+
+// Returns view container of workspace that was focused before the given amount of other ones, 0 being the most recent.
+// Returns NULL if workspace doesn't have that many view containers.
+struct e_view_container* e_workspace_get_recent_view_container(struct e_workspace* workspace, int index);
+
 // Get workspace from node ancestors.
 // Returns NULL on fail.
 struct e_workspace* e_workspace_try_from_node_ancestors(struct wlr_scene_node* node);
@@ -2,6 +2,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <time.h>
 
 #include <wayland-server-core.h>
 #include <wayland-util.h>
@@ -18,7 +19,6 @@
 //      + editing window container
 //  - e_view_set_maximized
 //  - e_view_set_resizing
-//  - e_view_set_suspended
 
 struct e_output;
 
@@ -57,11 +57,16 @@ struct e_view_impl
     // Set the fullscreen mode of the view.
     void (*set_fullscreen)(struct e_view* view, bool fullscreen);
 
+    // Set the suspended state of the view.
+    // May be NULL, if view type can't be suspended.
+    void (*set_suspended)(struct e_view* view, bool suspended);
+
     //void (*set_maximized)(struct e_view* view, bool maximized);
     //void (*set_resizing)(struct e_view* view, bool resizing);
     
     // Configure a view within given layout position and size.
-    void (*configure)(struct e_view* view, int lx, int ly, int width, int height);
+    // Returns serial the view will ack, or 0 if view type doesn't ack configures.
+    uint32_t (*configure)(struct e_view* view, int lx, int ly, int width, int height);
 
     // Create a scene tree displaying this view's surfaces and subsurfaces.
     // Returns NULL on fail.
@@ -154,6 +159,8 @@ struct e_view
     bool tiled;
     bool activated;
     bool fullscreen;
+    // View isn't visible, for example because its workspace isn't displayed.
+    bool suspended;
 
     // View's title.
     // May be NULL.
@@ -169,6 +176,44 @@ struct e_view
     // May be NULL.
     struct e_foreign_toplevel* foreign_toplevel;
 
+    // Configures sent to view, so identical ones aren't sent again and at most one is in flight.
+    struct
+    {
+        // Last sent geometry, empty if none was sent since view was mapped.
+        struct wlr_box sent;
+        // Serial of last sent configure, 0 if view type doesn't ack configures.
+        uint32_t serial;
+        struct timespec sent_time;
+        // Last sent configure wasn't committed by view yet.
+        bool in_flight;
+
+        // Latest geometry, waiting for the configure in flight to be acked.
+        struct wlr_box queued;
+        bool has_queued;
+
+        uint64_t sent_count;
+        // Identical or superseded configures that weren't sent.
+        uint64_t suppressed_count;
+        uint64_t acked_count;
+
+        // Time from sending a configure to view committing it.
+        double latency_last_ms;
+        double latency_max_ms;
+        double latency_total_ms;
+    } configures;
+
+    // Commits since commit rates were last reported.
+    struct
+    {
+        uint32_t commits;
+        // Commits while view wasn't visible.
+        uint32_t hidden_commits;
+    } commit_stats;
+
+    // Latest commit wasn't applied yet, because view is hidden.
+    bool commit_deferred;
+    struct wl_list deferred_link; //e_server::hidden_views::deferred_commits
+
     struct
     {
         // View is ready to be displayed.
@@ -220,8 +265,30 @@ void e_view_set_output(struct e_view* view, struct e_output* output);
 void e_view_set_popup_space(struct e_view* view, struct wlr_box toplevel_popup_space);
 
 // Configures a view within given layout position and size.
+// Configures identical to the last sent one are suppressed, and while one is in flight only the latest is kept.
 void e_view_configure(struct e_view* view, int lx, int ly, int width, int height);
 
+// Configures a view within given layout position and size, even if it already has or is getting it.
+// Used to answer requests that were denied, so the view knows its geometry didn't change.
+void e_view_configure_force(struct e_view* view, int lx, int ly, int width, int height);
+
+// Returns true if view isn't visible, because it isn't mapped, its workspace isn't displayed or a fullscreen container covers it.
+bool e_view_is_hidden(struct e_view* view);
+
+// View committed new surface state, emits commit signal.
+// Commits of hidden views are only applied once they're shown again.
+void e_view_commit(struct e_view* view);
+
+// Applies deferred commit of view if it is visible again.
+void e_view_flush_deferred_commit(struct e_view* view);
+
+// Applies deferred commits of views that are visible again.
+void e_view_flush_deferred_commits(struct e_server* server);
+
+// View committed, acking configures up to given serial.
+// Serial is 0 if view type doesn't ack configures, any commit then acks the last sent configure.
+void e_view_ack_configure(struct e_view* view, uint32_t serial);
+
 // Sets the tiled state of the view.
 void e_view_set_tiled(struct e_view* view, bool tiled);
 
@@ -231,13 +298,15 @@ void e_view_set_activated(struct e_view* view, bool activated);
 // Set the fullscreen mode of the view.
 void e_view_set_fullscreen(struct e_view* view, bool fullscreen);
 
+// Set the suspended state of the view, suspended views aren't visible and don't need to render.
+void e_view_set_suspended(struct e_view* view, bool suspended);
+
 void e_view_base_set_activated(struct e_view* view, bool activated);
 void e_view_base_set_fullscreen(struct e_view* view, bool fullscreen);
 
 /*
 void e_view_set_maximized(struct e_view* view, bool maximized);
 void e_view_set_resizing(struct e_view* view, bool resizing);
-void e_view_set_suspended(struct e_view* view, bool suspended);
 */
 
 // Returns NULL on fail.
@@ -82,6 +82,7 @@ struct e_xwayland_unmanaged
 };
 
 // Update useable geometry not covered by panels, docks, etc. for xwayland.
+// Workarea is only sent if it changed.
 void e_server_update_xwayland_workareas(struct e_server* server);
 
 /* xwayland view functions */
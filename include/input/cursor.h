@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include <wayland-server-core.h>
 
@@ -18,6 +19,9 @@
 struct e_output;
 struct e_container;
 
+// Max length of xcursor shape names, including null-terminator.
+#define E_CURSOR_XCURSOR_NAME_MAX 32
+
 enum e_cursor_mode
 {
     E_CURSOR_MODE_DEFAULT,
@@ -32,9 +36,25 @@ struct e_cursor
 
     struct wlr_cursor* wlr_cursor;
     struct wlr_xcursor_manager* xcursor_manager;
+    // Name of xcursor shape currently displayed, empty if cursor displays a client surface.
+    char xcursor_name[E_CURSOR_XCURSOR_NAME_MAX];
 
     enum e_cursor_mode mode;
 
+    // Keyboard focus change to hovered surface, coalesced until the next output frame and until cursor has rested on it.
+    struct
+    {
+        // Focus change is applied on the next output frame.
+        bool pending;
+        // Waiting for cursor to rest on surface for the configured delay.
+        bool dwelling;
+
+        // Root surface hovered when focus change was scheduled, only compared and never dereferenced.
+        struct wlr_surface* surface;
+
+        struct wl_event_source* dwell_timer;
+    } hover_focus;
+
     struct wl_listener frame;
 
     struct wl_listener button;
@@ -60,6 +80,16 @@ struct e_cursor* e_cursor_create(struct e_seat* seat, struct wlr_output_layout*
 
 void e_cursor_set_mode(struct e_cursor* cursor, enum e_cursor_mode mode);
 
+// Displays xcursor shape by name, does nothing if it is already displayed.
+void e_cursor_set_xcursor(struct e_cursor* cursor, const char* name);
+
+// Displays surface of a client as cursor image.
+// Surface is allowed to be NULL, which hides the cursor.
+void e_cursor_set_surface(struct e_cursor* cursor, struct wlr_surface* surface, int32_t hotspot_x, int32_t hotspot_y);
+
+// Loads xcursor theme for scale ahead of time, so cursor images are ready once cursor enters an output with that scale.
+void e_cursor_load_scale(struct e_cursor* cursor, float scale);
+
 // Lets go of a possibly grabbed view, & sets cursor mode to default.
 void e_cursor_reset_mode(struct e_cursor* cursor);
 
@@ -71,7 +101,11 @@ void e_cursor_start_container_resize(struct e_cursor* cursor, struct e_container
 void e_cursor_start_container_move(struct e_cursor* cursor, struct e_container* container);
 
 // Sets seat focus to whatever surface is under cursor.
+// Keyboard focus changes are coalesced, so only the last surface hovered gets focus.
 // If nothing is under cursor, doesn't change seat focus.
 void e_cursor_set_focus_hover(struct e_cursor* cursor);
 
+// Applies keyboard focus change to hovered surface, if one is waiting for this frame.
+void e_cursor_flush_focus_hover(struct e_cursor* cursor);
+
 void e_cursor_destroy(struct e_cursor* cursor);
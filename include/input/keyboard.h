@@ -7,11 +7,16 @@
 
 #include "input/seat.h"
 
+struct keyboard_keymap_job;
+
 struct e_keyboard
 {
     struct e_seat* seat;
     struct wlr_keyboard* wlr_keyboard;
 
+    // keymap being compiled on a worker thread, NULL if none
+    struct keyboard_keymap_job* keymap_job;
+
     //keyboard events
 
     //key pressed or released, emitted before keyboard xkb state is updated (including modifiers)
@@ -21,6 +21,9 @@ struct e_dnd_action
 {
     struct wlr_scene_tree* icon;
 
+    // Cursor moved since icon was last positioned, icon follows once per frame.
+    bool icon_moved;
+
     struct wl_listener motion;
     struct wl_listener destroy;
 };
@@ -87,6 +90,9 @@ bool e_seat_set_focus_view_container(struct e_seat* seat, struct e_view_containe
 // Returns whether this was succesful or not.
 bool e_seat_set_focus_layer_surface(struct e_seat* seat, struct e_layer_surface* layer_surface);
 
+// Moves drag & drop icon to cursor if cursor moved since, so icon is repositioned at most once per frame.
+void e_seat_update_drag_icon(struct e_seat* seat);
+
 // Returns true if seat has focus on this surface.
 bool e_seat_has_focus(struct e_seat* seat, struct wlr_surface* surface);
 
@@ -7,6 +7,7 @@
 #include <wayland-util.h>
 
 #include "protocols/transactions.h"
+#include "protocols/workspace-info.h"
 
 #define COSMIC_WORKSPACE_V1_VERSION 2
 
@@ -72,16 +73,6 @@ struct e_cosmic_workspace_group
     struct wl_list link; //e_cosmic_workspace_manager::groups
 };
 
-enum e_cosmic_workspace_state
-{
-    // Workspace is visible.
-    E_COSMIC_WORKSPACE_STATE_ACTIVE = 1 << 0,
-    // Workspace wants attention.
-    E_COSMIC_WORKSPACE_STATE_URGENT = 1 << 1,
-    // Workspace is not visible.
-    E_COSMIC_WORKSPACE_STATE_HIDDEN = 1 << 2
-};
-
 enum e_cosmic_workspace_tiling_state
 {
     E_COSMIC_WORKSPACE_TILING_STATE_FLOATING_ONLY = 0,
@@ -91,9 +82,6 @@ enum e_cosmic_workspace_tiling_state
 struct e_cosmic_workspace_request_tiling_state_event
 {
     enum e_cosmic_workspace_tiling_state tiling_state;
-
-    // Private
-    struct wl_listener destroy;
 };
 
 struct e_cosmic_workspace
@@ -101,15 +89,14 @@ struct e_cosmic_workspace
     // Group this workspace is assigned to.
     struct e_cosmic_workspace_group* group;
 
-    char* name;
+    // Shared state this workspace serializes, must outlive workspace.
+    struct e_workspace_info* info;
 
-    uint32_t state; //bitmask enum e_cosmic_workspace_state
-    uint32_t pending_state; //bitmask enum e_cosmic_workspace_state
+    // State last sent to clients, info's state is sent with the next done event.
+    uint32_t state; //bitmask enum e_workspace_info_state
 
     enum e_cosmic_workspace_tiling_state tiling_state;
 
-    struct wl_array coords;
-
     // Resource for each client that has binded to manager.
     struct wl_list resources; //struct wl_resource*
 
@@ -144,27 +131,17 @@ void e_cosmic_workspace_group_output_leave(struct e_cosmic_workspace_group* grou
 // Destroy workspace group and its workspaces.
 void e_cosmic_workspace_group_remove(struct e_cosmic_workspace_group* group);
 
-// Creates a new workspace inside workspace group.
+// Creates a new workspace inside workspace group, serializing given info.
+// Info must outlive workspace.
 // Returns NULL on fail.
-struct e_cosmic_workspace* e_cosmic_workspace_create(struct e_cosmic_workspace_group* group);
-
-// Name is copied.
-void e_cosmic_workspace_set_name(struct e_cosmic_workspace* workspace, const char* name);
-
-// Set coordinates of the workspace.
-void e_cosmic_workspace_set_coords(struct e_cosmic_workspace* workspace, struct wl_array* coords);
+struct e_cosmic_workspace* e_cosmic_workspace_create(struct e_cosmic_workspace_group* group, struct e_workspace_info* info);
 
 // Set whether or not workspace has tiling behaviour.
 void e_cosmic_workspace_set_tiling_state(struct e_cosmic_workspace* workspace, enum e_cosmic_workspace_tiling_state tiling_state);
 
-// Set whether or not workspace is active.
-void e_cosmic_workspace_set_active(struct e_cosmic_workspace* workspace, bool active);
-
-// Set whether or not workspace wants attention.
-void e_cosmic_workspace_set_urgent(struct e_cosmic_workspace* workspace, bool urgent);
-
-// Set whether or not workspace is hidden.
-void e_cosmic_workspace_set_hidden(struct e_cosmic_workspace* workspace, bool hidden);
+// Sends changed fields of workspace's info to clients, state is sent with the next done event.
+// Changes is a bitmask of enum e_workspace_info_change.
+void e_cosmic_workspace_update(struct e_cosmic_workspace* workspace, uint32_t changes);
 
 // Destroys workspace.
 void e_cosmic_workspace_remove(struct e_cosmic_workspace* workspace);
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <wayland-util.h>
 
 #include "protocols/transactions.h"
+#include "protocols/workspace-info.h"
 
 #define EXT_WORKSPACE_V1_VERSION 1
 
@@ -70,16 +71,6 @@ struct e_ext_workspace_group
     struct wl_list link; //e_ext_workspace_manager::groups
 };
 
-enum e_ext_workspace_state
-{
-    // Workspace is visible.
-    E_EXT_WORKSPACE_STATE_ACTIVE = 1 << 0,
-    // Workspace wants attention.
-    E_EXT_WORKSPACE_STATE_URGENT = 1 << 1,
-    // Workspace is not visible.
-    E_EXT_WORKSPACE_STATE_HIDDEN = 1 << 2
-};
-
 struct e_ext_workspace
 {
     struct e_ext_workspace_manager* manager;
@@ -88,12 +79,12 @@ struct e_ext_workspace
     struct e_ext_workspace_group* group;
 
     char* id;
-    char* name;
 
-    uint32_t state; //bitmask enum e_ext_workspace_state
-    uint32_t pending_state; //bitmask enum e_ext_workspace_state
+    // Shared state this workspace serializes, must outlive workspace.
+    struct e_workspace_info* info;
 
-    struct wl_array coords;
+    // State last sent to clients, info's state is sent with the next done event.
+    uint32_t state; //bitmask enum e_workspace_info_state
 
     // Resource for each client that has binded to manager.
     struct wl_list resources; //struct wl_resource*
@@ -129,30 +120,19 @@ void e_ext_workspace_group_output_leave(struct e_ext_workspace_group* group, str
 // Destroy workspace group and unassign its workspaces.
 void e_ext_workspace_group_remove(struct e_ext_workspace_group* group);
 
-// Creates a new workspace using workspace manager.
+// Creates a new workspace using workspace manager, serializing given info.
 // ID is allowed to be NULL.
+// Info must outlive workspace.
 // Returns NULL on fail.
-struct e_ext_workspace* e_ext_workspace_create(struct e_ext_workspace_manager* manager, const char* id);
+struct e_ext_workspace* e_ext_workspace_create(struct e_ext_workspace_manager* manager, const char* id, struct e_workspace_info* info);
 
 // Assign workspace to group, a workspace can only ever be assigned to one group at a time.
 // Group is allowed to be NULL.
 void e_ext_workspace_assign_to_group(struct e_ext_workspace* workspace, struct e_ext_workspace_group* group);
 
-// Set the name of workspace.
-// Name is copied.
-void e_ext_workspace_set_name(struct e_ext_workspace* workspace, const char* name);
-
-// Set coordinates of the workspace.
-void e_ext_workspace_set_coords(struct e_ext_workspace* workspace, struct wl_array* coords);
-
-// Set whether or not workspace is active.
-void e_ext_workspace_set_active(struct e_ext_workspace* workspace, bool active);
-
-// Set whether or not workspace wants attention.
-void e_ext_workspace_set_urgent(struct e_ext_workspace* workspace, bool urgent);
-
-// Set whether or not workspace is hidden.
-void e_ext_workspace_set_hidden(struct e_ext_workspace* workspace, bool hidden);
+// Sends changed fields of workspace's info to clients, state is sent with the next done event.
+// Changes is a bitmask of enum e_workspace_info_change.
+void e_ext_workspace_update(struct e_ext_workspace* workspace, uint32_t changes);
 
 // Destroys workspace.
 void e_ext_workspace_remove(struct e_ext_workspace* workspace);
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <wayland-server-core.h>
@@ -8,24 +9,39 @@
 // Allows a bunch of operations to be requested and done handled all at once, atomically.
 //TODO: currently only for protocol implementations, but might be useful for layout tiling updates too?
 
+// Max size of data that can be stored inside an operation.
+#define E_TRANS_OP_INLINE_DATA_SIZE 48
+
+// Max amount of destroyed operations a session keeps around for reuse.
+#define E_TRANS_SESSION_MAX_FREE_OPS 32
+
 // Keeps a list of transaction operations to be handled all at once when transaction is finished.
 struct e_trans_session
 {
     struct wl_list operations; //struct e_trans_op*
+
+    // Destroyed operations kept for reuse, so requests don't need to allocate.
+    struct wl_list free_operations; //struct e_trans_op*
+    int free_count;
 };
 
 // An operation to be performed when transaction is finished.
 struct e_trans_op
 {
+    struct e_trans_session* session;
+
     uint32_t type; //operation type
 
     void* src;
+    // Points to inline_data for operations created with e_trans_session_add_op_inline.
     void* data;
 
     // Fired when transaction operation is destroyed. Used to destroy data.
     struct wl_signal destroy;
 
-    struct wl_list link; //e_trans_session::operations
+    struct wl_list link; //e_trans_session::operations or e_trans_session::free_operations
+
+    _Alignas(max_align_t) unsigned char inline_data[E_TRANS_OP_INLINE_DATA_SIZE];
 };
 
 // Allows looping over operations inside current transaction of session, and destroying the current operation once finished.
@@ -38,8 +54,20 @@ void e_trans_session_init(struct e_trans_session* session);
 // Returns NULL on fail.
 struct e_trans_op* e_trans_session_add_op(struct e_trans_session* session, void* src, uint32_t type, void* data);
 
+// Creates a new operation for current transaction in session, with data of given size stored inside the operation.
+// Data is zeroed and must be filled in by caller, size must be at most E_TRANS_OP_INLINE_DATA_SIZE.
+// Returns NULL on fail.
+struct e_trans_op* e_trans_session_add_op_inline(struct e_trans_session* session, void* src, uint32_t type, size_t size);
+
+// Destroys every operation that has a later operation with the same src, where both their types are in types.
+// Types is a bitmask of (1 << type), so only the last of those operations is left for each src.
+void e_trans_session_keep_last(struct e_trans_session* session, uint32_t types);
+
 // Destroy all current operations inside session, basically starting a new transaction.
 void e_trans_session_clear(struct e_trans_session* session);
 
-// Frees e_trans_op and emits the destroy signal. To destroy data, use the destroy signal.
-void e_trans_op_destroy(struct e_trans_op* operation);
\ No newline at end of file
+// Destroys all operations and frees operations kept for reuse.
+void e_trans_session_fini(struct e_trans_session* session);
+
+// Emits the destroy signal and returns operation to its session for reuse, or frees it. To destroy data, use the destroy signal.
+void e_trans_op_destroy(struct e_trans_op* operation);
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include <wayland-server-core.h>
+#include <wayland-util.h>
+
+// Per client index of workspace protocol resources, shared by the cosmic & ext workspace protocol implementations.
+// Events for one client don't need to search every client's resources.
+
+// Sends events through a workspace protocol's generated functions.
+struct e_workspace_client_impl
+{
+    void (*send_manager_done)(struct wl_resource* manager_resource);
+
+    void (*send_group_output_enter)(struct wl_resource* group_resource, struct wl_resource* output_resource);
+    void (*send_group_output_leave)(struct wl_resource* group_resource, struct wl_resource* output_resource);
+};
+
+// Resources of a single client for one workspace protocol.
+// There is at most one per client & protocol, destroyed along with its client.
+struct e_workspace_client
+{
+    const struct e_workspace_client_impl* impl;
+
+    struct wl_array manager_resources; //struct wl_resource*
+    struct wl_array group_resources; //struct wl_resource*
+
+    struct wl_list link; //workspace clients of the same wayland client
+};
+
+// Returns NULL if client has no resources of protocol, or client is being destroyed.
+struct e_workspace_client* e_workspace_client_from_client(struct wl_client* client, const struct e_workspace_client_impl* impl);
+
+// Returns NULL on fail.
+struct e_workspace_client* e_workspace_client_get_or_create(struct wl_client* client, const struct e_workspace_client_impl* impl);
+
+// Returns true on success, false on fail.
+bool e_workspace_client_add_resource(struct wl_array* resources, struct wl_resource* resource);
+
+void e_workspace_client_remove_resource(struct wl_array* resources, struct wl_resource* resource);
+
+// Sends done event to every manager resource of client.
+void e_workspace_client_send_done(struct wl_client* client, const struct e_workspace_client_impl* impl);
+
+// Sends output enter or leave event for output resource to the group's resources of the same client.
+// Group is the user data of its resources.
+// Returns true if any event was sent.
+bool e_workspace_client_send_group_output_event(const struct e_workspace_client_impl* impl, void* group, struct wl_resource* output_resource, bool enter);
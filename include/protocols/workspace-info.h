@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <wayland-util.h>
+
+// Protocol independent workspace state, shared by the cosmic & ext workspace protocol implementations.
+// Changes are diffed once here, the protocol implementations only serialize changed fields to their clients.
+
+enum e_workspace_info_state
+{
+    // Workspace is visible.
+    E_WORKSPACE_INFO_STATE_ACTIVE = 1 << 0,
+    // Workspace wants attention.
+    E_WORKSPACE_INFO_STATE_URGENT = 1 << 1,
+    // Workspace is not visible.
+    E_WORKSPACE_INFO_STATE_HIDDEN = 1 << 2
+};
+
+enum e_workspace_info_change
+{
+    E_WORKSPACE_INFO_CHANGE_NAME = 1 << 0,
+    E_WORKSPACE_INFO_CHANGE_COORDS = 1 << 1,
+    E_WORKSPACE_INFO_CHANGE_STATE = 1 << 2
+};
+
+struct e_workspace_info
+{
+    // May be NULL.
+    char* name;
+
+    struct wl_array coords; //uint32_t
+
+    uint32_t state; //bitmask of enum e_workspace_info_state
+};
+
+void e_workspace_info_init(struct e_workspace_info* info);
+
+// Name is copied.
+// Returns bitmask of enum e_workspace_info_change, 0 if nothing changed.
+uint32_t e_workspace_info_set_name(struct e_workspace_info* info, const char* name);
+
+// Coords are copied.
+// Returns bitmask of enum e_workspace_info_change, 0 if nothing changed.
+uint32_t e_workspace_info_set_coords(struct e_workspace_info* info, struct wl_array* coords);
+
+// Set whether or not workspace is in a specific state.
+// Returns bitmask of enum e_workspace_info_change, 0 if nothing changed.
+uint32_t e_workspace_info_set_state(struct e_workspace_info* info, enum e_workspace_info_state state, bool enabled);
+
+void e_workspace_info_fini(struct e_workspace_info* info);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <time.h>
 
 #include <wayland-server-core.h>
 #include <wayland-util.h>
@@ -12,10 +13,12 @@
 #include <wlr/types/wlr_cursor.h>
 #include <wlr/types/wlr_scene.h>
 #include <wlr/types/wlr_output_layout.h>
+#include <wlr/util/box.h>
 
 #include "config.h"
 
 struct e_seat;
+struct e_thread_pool;
 
 struct wlr_xdg_shell;
 struct wlr_layer_shell_v1;
@@ -29,6 +32,7 @@ struct e_cosmic_workspace_manager;
 struct e_ext_workspace_manager;
 
 struct wlr_relative_pointer_manager_v1;
+struct wlr_output_manager_v1;
 
 #define E_COMPOSITOR_VERSION 6
 
@@ -36,6 +40,7 @@ struct wlr_relative_pointer_manager_v1;
 #define E_LAYER_SHELL_VERSION 4
 
 #define E_PRESENTATION_TIME_VERSION 2
+#define E_FRACTIONAL_SCALE_VERSION 1
 #define E_EXT_DATA_CONTROL_V1_VERSION 1
 #define E_EXT_IMAGE_CAPTURE_SOURCE_VERSION 1
 #define E_EXT_IMAGE_COPY_CAPTURE_VERSION 1
@@ -57,15 +62,45 @@ struct e_server
 
     struct wl_event_loop* event_loop;
 
+    // runs blocking work off the event loop, NULL if it failed to be created
+    struct e_thread_pool* thread_pool;
+
     //event sources
     struct
     {
         struct wl_event_source* sigint;
         struct wl_event_source* sigterm;
+#if E_TRACE
+        // exports recorded trace events on SIGUSR1
+        struct wl_event_source* sigusr1;
+#endif
+        // logs resource usage of clients on SIGUSR2
+        struct wl_event_source* sigusr2;
+        // creates deferred globals if no output presents a frame in time, NULL once they're created
+        struct wl_event_source* deferred_timeout;
     } sources;
 
+    // startup phase timings
+    struct
+    {
+        // monotonic time startup began & previous phase ended
+        struct timespec start, last_phase;
+
+        bool first_frame;
+        // globals not needed for the first frame have been created
+        bool deferred_done;
+    } startup;
+
+    struct
+    {
+        // server has finished starting up, including deferred globals
+        struct wl_signal ready;
+    } events;
+
     // handles accepting clients from Unix socket, managing wl globals, ...
     struct wl_display* display;
+    // event loop is being run, false once server is terminated
+    bool running;
 
     // handles input and output hardware
     struct wlr_backend* backend;
@@ -97,6 +132,10 @@ struct e_server
     // XCB connection is valid.
     struct wl_listener xwayland_ready;
     struct wl_listener new_xwayland_surface;
+
+    // Workarea last sent to xwayland, only valid if one was sent on current connection.
+    struct wlr_box xwayland_workarea;
+    bool xwayland_workarea_sent;
 #endif
 
     struct wlr_ext_foreign_toplevel_list_v1* foreign_toplevel_list;
@@ -111,6 +150,27 @@ struct e_server
     struct wl_list outputs; //struct e_output* 
     // wlroots utility for working with arrangement of screens in a physical layout
     struct wlr_output_layout* output_layout;
+    // output layout changed, output management clients need the new configuration
+    struct wl_listener output_layout_change;
+
+    // lets clients configure outputs (wlr output management protocol)
+    struct wlr_output_manager_v1* output_manager;
+    struct wl_listener output_manager_apply;
+    struct wl_listener output_manager_test;
+    // sends current configuration to output management clients, NULL if not scheduled
+    struct wl_event_source* output_manager_update_idle;
+
+    // Outputs added & removed at runtime are collected until no more arrive for a moment, then all outputs are arranged once.
+    struct
+    {
+        // fires once hotplugs settled, restarted by every hotplug
+        struct wl_event_source* settle_timer;
+
+        int outputs_added;
+        int outputs_removed;
+        // amount of output arranges that would've happened without settling
+        int arranges_requested;
+    } hotplug;
 
     // root node of the scene.
     // handles all rendering & damage tracking, 
@@ -127,6 +187,28 @@ struct e_server
 
     struct wl_list view_containers; //struct e_view_container*
 
+    // Connected clients and the resources they use.
+    struct
+    {
+        struct wl_list list; //struct e_client*
+        struct wl_listener created;
+        // counts surfaces & their buffers per client
+        struct wl_listener new_surface;
+        // time client stats were last logged
+        struct timespec report_time;
+    } clients;
+
+    // Views that aren't visible get frame callbacks at a low rate, and their commits are only applied once shown again.
+    struct
+    {
+        // sends frame callbacks to hidden views & reports commit rates
+        struct wl_event_source* frame_timer;
+        // views with commits that weren't applied yet, because they were hidden
+        struct wl_list deferred_commits; //struct e_view*
+        // time commit rates were last reported
+        struct timespec report_time;
+    } hidden_views;
+
     // collection & management of input devices: keyboard, mouse, ...
     struct e_seat* seat;
 };
@@ -135,10 +217,17 @@ struct e_server
 bool e_server_init_outputs(struct e_server* server);
 void e_server_fini_outputs(struct e_server* server);
 
+// Init output capturing protocols (screencopy, export dmabuf, ext image capture).
+void e_server_init_output_capture(struct e_server* server);
+
 // Init xdg shell handling.
 bool e_server_init_xdg_shell(struct e_server* server);
 void e_server_fini_xdg_shell(struct e_server* server);
 
+// Init handling of views that aren't visible.
+bool e_server_init_views(struct e_server* server);
+void e_server_fini_views(struct e_server* server);
+
 // Init layer shell handling.
 bool e_server_init_layer_shell(struct e_server* server);
 void e_server_fini_layer_shell(struct e_server* server);
@@ -151,6 +240,13 @@ void e_server_fini_xwayland(struct e_server* server);
 
 int e_server_init(struct e_server* server, struct e_config* config);
 
+// Logs time spent since previous startup phase ended, and total time since startup began.
+void e_server_startup_phase(struct e_server* server, const char* phase);
+
+// Call when an output has committed a frame.
+// Globals that weren't needed for the first frame are created after the first one.
+void e_server_handle_output_frame(struct e_server* server);
+
 bool e_server_start(struct e_server* server);
 
 void e_server_run(struct e_server* server);
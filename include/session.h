@@ -1,6 +1,18 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
+
+// Buffer size for config paths (env, autostart, config, ...)
+#define E_CONFIG_PATHS_MAX_SIZE 1024
+
+// Outs path to EstrogenWL's config directory with a null-terminator.
+// Returns length of path (as if weren't truncated).
+size_t e_session_get_config_path(char* buffer, size_t maxlen);
+
+// Outs full path using file path relative to config path into buffer with a null-terminator.
+// Returns length of path (as if weren't truncated).
+size_t e_session_get_relative_config_path(char* buffer, size_t maxlen, const char* path);
 
 // Set environment variables from pairs inside environment config file
 // Format: (name)=(value)
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include <wayland-server-core.h>
+
+// Small pool of worker threads for blocking work, so it doesn't stall the event loop.
+// Jobs are run on a worker thread, then completed on the event loop's thread through an eventfd.
+
+// Runs on a worker thread, must not touch compositor state or log.
+typedef void (*e_thread_job_work_func_t)(void* data);
+// Runs on the event loop's thread once work is done.
+typedef void (*e_thread_job_done_func_t)(void* data);
+
+struct e_thread_pool;
+
+// Creates a pool of thread_count worker threads, that completes jobs on event loop.
+// Returns NULL on fail.
+struct e_thread_pool* e_thread_pool_create(struct wl_event_loop* event_loop, int thread_count);
+
+// Queues work to be run on a worker thread, done is called on the event loop's thread after.
+// Done is allowed to be NULL.
+// Returns true on success, false on fail.
+bool e_thread_pool_submit(struct e_thread_pool* pool, e_thread_job_work_func_t work, e_thread_job_done_func_t done, void* data);
+
+// Finishes all queued jobs, then destroys pool.
+void e_thread_pool_destroy(struct e_thread_pool* pool);
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <time.h>
+
+// Time functions
+
+// Returns current time of monotonic clock.
+struct timespec e_time_now(void);
+
+// Returns amount of milliseconds from start to end.
+double e_time_diff_ms(const struct timespec* start, const struct timespec* end);
@@ -0,0 +1,40 @@
+#pragma once
+
+// Tracepoints of hot paths, recorded into a buffer per thread and exported as Chrome trace JSON.
+// Exported traces can be opened in chrome://tracing or ui.perfetto.dev.
+// Tracepoints are only compiled in with the trace build option, otherwise they are removed.
+
+#if E_TRACE
+
+#include <stdbool.h>
+
+// Max amount of events recorded per thread, oldest events are overwritten once full.
+#define E_TRACE_BUFFER_SIZE 65536
+
+// Max amount of nested spans per thread.
+#define E_TRACE_MAX_DEPTH 32
+
+// Starts a named span on the calling thread, spans may be nested.
+// Name is written into the exported JSON as is, so it must be a string literal without quotes or backslashes.
+void e_trace_begin(const char* name);
+
+// Ends the last begun span on the calling thread.
+void e_trace_end(void);
+
+// Writes events recorded by all threads as Chrome trace JSON to file at path.
+// Returns true on success, false on fail.
+bool e_trace_export(const char* path);
+
+// Frees buffers of all threads.
+// No other thread may trace anymore once this is called.
+void e_trace_fini(void);
+
+#define E_TRACE_BEGIN(name) e_trace_begin(name)
+#define E_TRACE_END() e_trace_end()
+
+#else
+
+#define E_TRACE_BEGIN(name) ((void)0)
+#define E_TRACE_END() ((void)0)
+
+#endif
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdbool.h>
+
+// Event loop stall detection.
+// Compositor runs on a single thread, so any slow handler freezes every client & output.
+
+// Event loop dispatches taking longer than this amount of milliseconds are logged.
+#define E_WATCHDOG_STALL_MS 50.0
+
+// Event loop dispatches taking longer than this amount of milliseconds are reported by the watchdog thread while they're still running.
+#define E_WATCHDOG_HANG_MS 2000
+
+// Max amount of nested sections that are tracked.
+#define E_WATCHDOG_MAX_DEPTH 8
+
+// Starts watchdog thread, which reports hangs of the event loop with the current section and a backtrace of the event loop thread.
+// Must be called from the event loop thread.
+// Returns true on success, false on fail.
+bool e_watchdog_start(void);
+
+// Stops watchdog thread.
+void e_watchdog_stop(void);
+
+// Starts timing a dispatch of the event loop.
+void e_watchdog_dispatch_begin(void);
+
+// Stops timing the current dispatch of the event loop, logs it if it stalled with its slowest section.
+void e_watchdog_dispatch_end(void);
+
+// Starts timing a named section of work, sections may be nested.
+// Name must stay valid until the dispatch ends, use string literals.
+void e_watchdog_section_begin(const char* name);
+
+// Stops timing the last begun section.
+void e_watchdog_section_end(void);
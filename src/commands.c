@@ -17,7 +17,6 @@
 
 #include "desktop/views/view.h"
 
-#include "input/cursor.h"
 #include "input/seat.h"
 
 #include "util/list.h"
@@ -198,6 +197,33 @@ void e_commands_parse(struct e_server* server, const char* command)
         e_log_info("maximize");
         //TODO: maximize
     }
+    //switch focus to view container focused before the current one on its workspace
+    else if (strcmp(argument, "focus_previous") == 0)
+    {
+        struct e_view_container* focused_view_container = e_desktop_focused_view_container(server);
+
+        struct e_workspace* workspace = NULL;
+
+        if (focused_view_container != NULL)
+            workspace = focused_view_container->base.workspace;
+
+        if (workspace == NULL)
+        {
+            struct e_output* output = e_desktop_hovered_output(server);
+
+            if (output != NULL)
+                workspace = output->active_workspace;
+        }
+
+        if (workspace == NULL)
+            return;
+
+        //without a focused view container, the most recent one is the previous one
+        struct e_view_container* previous_view_container = e_workspace_get_recent_view_container(workspace, (focused_view_container != NULL) ? 1 : 0);
+
+        if (previous_view_container != NULL)
+            e_desktop_set_focus_view_container(server, previous_view_container);
+    }
     //TODO: next_workspace is for testing only, remove
     else if (strcmp(argument, "next_workspace") == 0)
     {
@@ -211,11 +237,17 @@ void e_commands_parse(struct e_server* server, const char* command)
             return;
         }
 
-        int i = e_list_find_index(&output->workspace_group.workspaces, workspace);
+        int i = e_output_get_workspace_index(output, workspace);
+
+        //created on demand
+        struct e_workspace* next_workspace = e_output_get_workspace(output, (i + 1) % E_OUTPUT_WORKSPACE_SLOTS);
 
-        e_output_display_workspace(output, e_list_at(&output->workspace_group.workspaces, (i + 1) % output->workspace_group.workspaces.count));
-        e_cursor_set_focus_hover(server->seat->cursor);
-        e_log_info("output workspace index: %i", (i + 1) % output->workspace_group.workspaces.count);
+        if (next_workspace == NULL || next_workspace == workspace)
+            return;
+
+        e_output_display_workspace(output, next_workspace);
+        e_desktop_focus_workspace(server, next_workspace);
+        e_log_info("output workspace index: %i", (i + 1) % E_OUTPUT_WORKSPACE_SLOTS);
     }
     //TODO: testing only, remove
     else if (strcmp(argument, "move_to_next_workspace") == 0)
@@ -237,19 +269,27 @@ void e_commands_parse(struct e_server* server, const char* command)
 
         struct e_output* output = old_workspace->output;
 
-        int i = e_list_find_index(&output->workspace_group.workspaces, old_workspace);
+        int i = e_output_get_workspace_index(output, old_workspace);
+
+        //created on demand
+        struct e_workspace* new_workspace = e_output_get_workspace(output, (i + 1) % E_OUTPUT_WORKSPACE_SLOTS);
 
-        struct e_workspace* new_workspace = e_list_at(&output->workspace_group.workspaces, (i + 1) % output->workspace_group.workspaces.count);
+        if (new_workspace == NULL)
+            return;
 
         e_container_move_to_workspace(container, new_workspace);
 
         e_workspace_rearrange(old_workspace);
 
         if (new_workspace != old_workspace)
+        {
             e_workspace_rearrange(new_workspace);
 
-        e_cursor_set_focus_hover(server->seat->cursor);
-        e_log_info("container workspace index: %i", (i + 1) % output->workspace_group.workspaces.count);
+            //container left the displayed workspace, focus the one focused before it
+            if (old_workspace->active)
+                e_desktop_focus_workspace(server, old_workspace);
+        }
+        e_log_info("container workspace index: %i", (i + 1) % E_OUTPUT_WORKSPACE_SLOTS);
     }
     else 
     {
@@ -1,13 +1,29 @@
 #include "config.h"
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
 #include <assert.h>
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <wlr/types/wlr_keyboard.h>
+
+#include <xkbcommon/xkbcommon.h>
+
 #include "desktop/tree/container.h"
 
 #include "input/keybind.h"
 
 #include "util/list.h"
+#include "util/log.h"
 
 void e_config_init(struct e_config* config)
 {
@@ -19,13 +35,589 @@ void e_config_init(struct e_config* config)
     config->keyboard.repeat_rate_hz = 25;
     config->keyboard.repeat_delay_ms = 600;
 
+    config->output_count = 0;
+
     config->xwayland_lazy = true;
+
+    config->foreign_toplevel_max_rate_hz = 0;
+
+    config->hidden_view_frame_rate_hz = 1;
+
+    config->hover_focus_delay_ms = 0;
+
+    config->client_limits.buffer_memory_mb = 0;
+    config->client_limits.surfaces = 0;
+    config->client_limits.kill = false;
+
+    config->source.data = NULL;
+    config->source.size = 0;
+    config->source.mapped = false;
+}
+
+/* source */
+
+// Loads file at path into config's source with a null-terminator after its last byte.
+// Returns true on success, false on fail.
+static bool config_source_load(struct e_config* config, const char* path)
+{
+    assert(config && path);
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+    {
+        e_log_error("config_source_load: failed to open %s", path);
+        return false;
+    }
+
+    struct stat file_stat;
+
+    if (fstat(fd, &file_stat) != 0)
+    {
+        e_log_error("config_source_load: failed to stat %s", path);
+        close(fd);
+        return false;
+    }
+
+    size_t size = file_stat.st_size;
+    long page_size = sysconf(_SC_PAGESIZE);
+
+    char* data = NULL;
+    bool mapped = false;
+
+    //bytes after the end of the file inside its last page are zero, which leaves room for a null-terminator,
+    //unless the file fills its last page exactly, then fall back to reading it into memory
+    //mapping is private, so tokenizing in place never writes back to the file
+    if (size > 0 && page_size > 0 && size % (size_t)page_size != 0)
+    {
+        data = mmap(NULL, size + 1, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+        if (data != MAP_FAILED)
+            mapped = true;
+        else
+            data = NULL;
+    }
+
+    if (data == NULL)
+    {
+        data = malloc(size + 1);
+
+        if (data == NULL)
+        {
+            e_log_error("config_source_load: failed to allocate %zu bytes", size + 1);
+            close(fd);
+            return false;
+        }
+
+        size_t read_size = 0;
+
+        while (read_size < size)
+        {
+            ssize_t result = read(fd, data + read_size, size - read_size);
+
+            if (result <= 0)
+                break;
+
+            read_size += result;
+        }
+
+        size = read_size;
+        data[size] = '\0';
+    }
+
+    close(fd);
+
+    config->source.data = data;
+    config->source.size = size;
+    config->source.mapped = mapped;
+
+    return true;
+}
+
+static void config_source_free(struct e_config* config)
+{
+    assert(config);
+
+    if (config->source.data == NULL)
+        return;
+
+    if (config->source.mapped)
+        munmap(config->source.data, config->source.size + 1);
+    else
+        free(config->source.data);
+
+    config->source.data = NULL;
+    config->source.size = 0;
+    config->source.mapped = false;
+}
+
+/* tokenizing */
+
+static bool is_blank(char character)
+{
+    return character == ' ' || character == '\t' || character == '\r';
+}
+
+// Returns next whitespace separated token in line, and null-terminates it in place.
+// Line is advanced to after the token.
+// Returns NULL if there are no tokens left.
+static char* next_token(char** line)
+{
+    char* start = *line;
+
+    while (is_blank(*start))
+        start++;
+
+    if (*start == '\0')
+    {
+        *line = start;
+        return NULL;
+    }
+
+    char* end = start;
+
+    while (*end != '\0' && !is_blank(*end))
+        end++;
+
+    if (*end != '\0')
+    {
+        *end = '\0';
+        end++;
+    }
+
+    *line = end;
+
+    return start;
+}
+
+// Returns rest of line without leading & trailing whitespace, null-terminated in place.
+// Returns NULL if rest of line is empty.
+static char* rest_of_line(char* line)
+{
+    while (is_blank(*line))
+        line++;
+
+    if (*line == '\0')
+        return NULL;
+
+    char* end = line + strlen(line);
+
+    while (end > line && is_blank(end[-1]))
+        end--;
+
+    *end = '\0';
+
+    return line;
+}
+
+/* parsing */
+
+// Returns 0 if name is not a known modifier.
+static enum wlr_keyboard_modifier modifier_from_name(const char* name)
+{
+    if (strcasecmp(name, "shift") == 0)
+        return WLR_MODIFIER_SHIFT;
+    else if (strcasecmp(name, "caps") == 0)
+        return WLR_MODIFIER_CAPS;
+    else if (strcasecmp(name, "ctrl") == 0 || strcasecmp(name, "control") == 0)
+        return WLR_MODIFIER_CTRL;
+    else if (strcasecmp(name, "alt") == 0 || strcasecmp(name, "mod1") == 0)
+        return WLR_MODIFIER_ALT;
+    else if (strcasecmp(name, "mod2") == 0)
+        return WLR_MODIFIER_MOD2;
+    else if (strcasecmp(name, "mod3") == 0)
+        return WLR_MODIFIER_MOD3;
+    else if (strcasecmp(name, "logo") == 0 || strcasecmp(name, "super") == 0 || strcasecmp(name, "mod4") == 0)
+        return WLR_MODIFIER_LOGO;
+    else if (strcasecmp(name, "mod5") == 0)
+        return WLR_MODIFIER_MOD5;
+
+    return 0;
+}
+
+// Parses key combination, for example: logo+shift+F1
+// Returns true on success, false on fail.
+static bool parse_key_combo(char* combo, xkb_keysym_t* keysym, enum wlr_keyboard_modifier* mods)
+{
+    *mods = 0;
+
+    char* part = combo;
+    char* separator = NULL;
+
+    //every part before the last + is a modifier
+    while ((separator = strchr(part, '+')) != NULL && separator[1] != '\0')
+    {
+        *separator = '\0';
+
+        enum wlr_keyboard_modifier modifier = modifier_from_name(part);
+
+        if (modifier == 0)
+        {
+            e_log_error("parse_key_combo: unknown modifier %s", part);
+            return false;
+        }
+
+        *mods |= modifier;
+        part = separator + 1;
+    }
+
+    *keysym = xkb_keysym_from_name(part, XKB_KEYSYM_CASE_INSENSITIVE);
+
+    if (*keysym == XKB_KEY_NoSymbol)
+    {
+        e_log_error("parse_key_combo: unknown key %s", part);
+        return false;
+    }
+
+    return true;
+}
+
+static bool parse_bool(const char* value, bool* out)
+{
+    if (strcasecmp(value, "true") == 0 || strcasecmp(value, "yes") == 0 || strcmp(value, "1") == 0)
+        *out = true;
+    else if (strcasecmp(value, "false") == 0 || strcasecmp(value, "no") == 0 || strcmp(value, "0") == 0)
+        *out = false;
+    else
+        return false;
+
+    return true;
+}
+
+// Parses scale, must be above 0 and at most 10.
+static bool parse_scale(const char* value, float* out)
+{
+    char* end = NULL;
+    float result = strtof(value, &end);
+
+    if (end == value || *end != '\0' || !(result > 0.0f && result <= 10.0f))
+        return false;
+
+    *out = result;
+    return true;
+}
+
+static bool parse_int32(const char* value, int32_t* out)
+{
+    char* end = NULL;
+    long result = strtol(value, &end, 10);
+
+    if (end == value || *end != '\0' || result < 0 || result > INT32_MAX)
+        return false;
+
+    *out = (int32_t)result;
+    return true;
+}
+
+// Parses a single null-terminated line of a config file into config.
+// Format: (name) (value)
+// Returns true on success, false on fail.
+static bool parse_line(struct e_config* config, char* line, int line_num)
+{
+    char* name = next_token(&line);
+
+    //empty or comment
+    if (name == NULL || name[0] == '#')
+        return true;
+
+    if (strcmp(name, "bind") == 0)
+    {
+        //format: bind (modifiers+key) (command)
+        char* combo = next_token(&line);
+        char* command = rest_of_line(line);
+
+        if (combo == NULL || command == NULL)
+        {
+            e_log_error("config line %i: bind requires a key combination and a command", line_num);
+            return false;
+        }
+
+        xkb_keysym_t keysym;
+        enum wlr_keyboard_modifier mods;
+
+        if (!parse_key_combo(combo, &keysym, &mods))
+        {
+            e_log_error("config line %i: invalid key combination", line_num);
+            return false;
+        }
+
+        //command points into config source
+        struct e_keybind* keybind = e_keybind_create(keysym, mods, command);
+
+        if (keybind == NULL)
+            return false;
+
+        if (!e_list_add(&config->keyboard.keybinds, keybind))
+        {
+            e_keybind_free(keybind);
+            return false;
+        }
+
+        return true;
+    }
+
+    if (strcmp(name, "output_scale") == 0)
+    {
+        //format: output_scale (output name) (scale)
+        char* output_name = next_token(&line);
+        char* scale = next_token(&line);
+
+        if (output_name == NULL || scale == NULL)
+        {
+            e_log_error("config line %i: output_scale requires an output name and a scale", line_num);
+            return false;
+        }
+
+        if (strlen(output_name) >= E_CONFIG_OUTPUT_NAME_MAX)
+        {
+            e_log_error("config line %i: output name is longer than %i characters", line_num, E_CONFIG_OUTPUT_NAME_MAX - 1);
+            return false;
+        }
+
+        struct e_output_config* output_config = e_config_get_output(config, output_name);
+
+        if (output_config == NULL)
+        {
+            if (config->output_count >= E_CONFIG_MAX_OUTPUTS)
+            {
+                e_log_error("config line %i: can't configure more than %i outputs", line_num, E_CONFIG_MAX_OUTPUTS);
+                return false;
+            }
+
+            output_config = &config->outputs[config->output_count];
+            config->output_count++;
+
+            snprintf(output_config->name, E_CONFIG_OUTPUT_NAME_MAX, "%s", output_name);
+        }
+
+        if (!parse_scale(scale, &output_config->scale))
+        {
+            e_log_error("config line %i: invalid scale %s for output %s", line_num, scale, output_name);
+            return false;
+        }
+
+        return true;
+    }
+
+    char* value = next_token(&line);
+
+    if (value == NULL)
+    {
+        e_log_error("config line %i: %s has no value", line_num, name);
+        return false;
+    }
+
+    bool valid = false;
+
+    if (strcmp(name, "repeat_rate") == 0)
+    {
+        valid = parse_int32(value, &config->keyboard.repeat_rate_hz);
+    }
+    else if (strcmp(name, "repeat_delay") == 0)
+    {
+        valid = parse_int32(value, &config->keyboard.repeat_delay_ms);
+    }
+    else if (strcmp(name, "xwayland_lazy") == 0)
+    {
+        valid = parse_bool(value, &config->xwayland_lazy);
+    }
+    else if (strcmp(name, "foreign_toplevel_max_rate") == 0)
+    {
+        valid = parse_int32(value, &config->foreign_toplevel_max_rate_hz);
+    }
+    else if (strcmp(name, "hidden_view_frame_rate") == 0)
+    {
+        valid = parse_int32(value, &config->hidden_view_frame_rate_hz) && config->hidden_view_frame_rate_hz <= 1000;
+    }
+    else if (strcmp(name, "hover_focus_delay") == 0)
+    {
+        valid = parse_int32(value, &config->hover_focus_delay_ms);
+    }
+    else if (strcmp(name, "client_buffer_memory_limit") == 0)
+    {
+        valid = parse_int32(value, &config->client_limits.buffer_memory_mb);
+    }
+    else if (strcmp(name, "client_surface_limit") == 0)
+    {
+        valid = parse_int32(value, &config->client_limits.surfaces);
+    }
+    else if (strcmp(name, "client_limit_kill") == 0)
+    {
+        valid = parse_bool(value, &config->client_limits.kill);
+    }
+    else if (strcmp(name, "tiling_mode") == 0)
+    {
+        valid = true;
+
+        if (strcasecmp(value, "horizontal") == 0)
+            config->current_tiling_mode = E_TILING_MODE_HORIZONTAL;
+        else if (strcasecmp(value, "vertical") == 0)
+            config->current_tiling_mode = E_TILING_MODE_VERTICAL;
+        else
+            valid = false;
+    }
+    else
+    {
+        e_log_error("config line %i: unknown option %s", line_num, name);
+        return false;
+    }
+
+    if (!valid)
+        e_log_error("config line %i: invalid value %s for %s", line_num, value, name);
+
+    return valid;
+}
+
+// Parses config file at file_path into out, out must already be inited.
+// Options not set inside the file keep their current value in out.
+// Returns true on success, false on fail.
+bool e_config_parse_config_file(const char* file_path, struct e_config* out)
+{
+    assert(file_path && out);
+
+    if (file_path == NULL || out == NULL)
+    {
+        e_log_error("e_config_parse_config_file: file_path or out is NULL");
+        return false;
+    }
+
+    if (out->source.data != NULL)
+    {
+        e_log_error("e_config_parse_config_file: out already has a parsed config file");
+        return false;
+    }
+
+    //parse into a copy, so out is left untouched on fail
+    struct e_config parsed = *out;
+
+    if (!e_list_init(&parsed.keyboard.keybinds, 10))
+        return false;
+
+    parsed.source.data = NULL;
+
+    if (!config_source_load(&parsed, file_path))
+    {
+        e_list_fini(&parsed.keyboard.keybinds);
+        return false;
+    }
+
+    //tokenize in place: every line break becomes a null-terminator, tokens & commands point into source
+    char* data = parsed.source.data;
+    size_t line_start = 0;
+    int line_num = 0;
+    bool success = true;
+
+    while (line_start < parsed.source.size)
+    {
+        char* line = data + line_start;
+        char* line_end = memchr(line, '\n', parsed.source.size - line_start);
+
+        //last line is already null-terminated by source
+        if (line_end != NULL)
+            *line_end = '\0';
+
+        line_num++;
+
+        if (!parse_line(&parsed, line, line_num))
+        {
+            success = false;
+            break;
+        }
+
+        line_start = (line_end != NULL) ? (size_t)(line_end - data) + 1 : parsed.source.size;
+    }
+
+    if (!success)
+    {
+        e_log_error("e_config_parse_config_file: failed to parse %s", file_path);
+        e_config_fini(&parsed);
+        return false;
+    }
+
+    out->current_tiling_mode = parsed.current_tiling_mode;
+    out->keyboard.repeat_rate_hz = parsed.keyboard.repeat_rate_hz;
+    out->keyboard.repeat_delay_ms = parsed.keyboard.repeat_delay_ms;
+    out->xwayland_lazy = parsed.xwayland_lazy;
+
+    memcpy(out->outputs, parsed.outputs, sizeof(out->outputs));
+    out->output_count = parsed.output_count;
+    out->foreign_toplevel_max_rate_hz = parsed.foreign_toplevel_max_rate_hz;
+    out->hidden_view_frame_rate_hz = parsed.hidden_view_frame_rate_hz;
+    out->hover_focus_delay_ms = parsed.hover_focus_delay_ms;
+    out->client_limits = parsed.client_limits;
+
+    for (int i = 0; i < parsed.keyboard.keybinds.count; i++)
+        e_list_add(&out->keyboard.keybinds, e_list_at(&parsed.keyboard.keybinds, i));
+
+    out->source = parsed.source;
+
+    e_list_fini(&parsed.keyboard.keybinds);
+
+    e_log_info("parsed config file %s (%i keybinds)", file_path, out->keyboard.keybinds.count);
+
+    return true;
+}
+
+// Returns config of output with name, NULL if output isn't configured.
+struct e_output_config* e_config_get_output(struct e_config* config, const char* name)
+{
+    assert(config && name);
+
+    for (int i = 0; i < config->output_count; i++)
+    {
+        if (strcmp(config->outputs[i].name, name) == 0)
+            return &config->outputs[i];
+    }
+
+    return NULL;
+}
+
+// Returns true if both configs have the same keybinds in the same order.
+bool e_config_keybinds_equal(struct e_config* a, struct e_config* b)
+{
+    assert(a && b);
+
+    if (a->keyboard.keybinds.count != b->keyboard.keybinds.count)
+        return false;
+
+    for (int i = 0; i < a->keyboard.keybinds.count; i++)
+    {
+        struct e_keybind* keybind_a = e_list_at(&a->keyboard.keybinds, i);
+        struct e_keybind* keybind_b = e_list_at(&b->keyboard.keybinds, i);
+
+        if (keybind_a->keysym != keybind_b->keysym || keybind_a->mods != keybind_b->mods || strcmp(keybind_a->command, keybind_b->command) != 0)
+            return false;
+    }
+
+    return true;
+}
+
+// Swaps keybinds and the source they point into between both configs.
+void e_config_swap_keybinds(struct e_config* a, struct e_config* b)
+{
+    assert(a && b);
+
+    struct e_list keybinds = a->keyboard.keybinds;
+    a->keyboard.keybinds = b->keyboard.keybinds;
+    b->keyboard.keybinds = keybinds;
+
+    char* data = a->source.data;
+    size_t size = a->source.size;
+    bool mapped = a->source.mapped;
+
+    a->source.data = b->source.data;
+    a->source.size = b->source.size;
+    a->source.mapped = b->source.mapped;
+
+    b->source.data = data;
+    b->source.size = size;
+    b->source.mapped = mapped;
 }
 
 void e_config_fini(struct e_config* config)
 {
     assert(config);
-    
+
     for (int i = 0; i < config->keyboard.keybinds.count; i++)
     {
         struct e_keybind* keybind = e_list_at(&config->keyboard.keybinds, i);
@@ -35,4 +627,6 @@ void e_config_fini(struct e_config* config)
     }
 
     e_list_fini(&config->keyboard.keybinds);
+
+    config_source_free(config);
 }
@@ -0,0 +1,267 @@
+#include "config_watch.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <unistd.h>
+
+#include <sys/inotify.h>
+
+#include <wayland-server-core.h>
+#include <wayland-util.h>
+
+#include <wlr/types/wlr_keyboard.h>
+
+#include "desktop/output.h"
+
+#include "input/seat.h"
+#include "input/keyboard.h"
+
+#include "util/log.h"
+
+#include "config.h"
+#include "server.h"
+
+// Returns true if both configs configure the same outputs the same way.
+static bool config_outputs_equal(struct e_config* a, struct e_config* b)
+{
+    if (a->output_count != b->output_count)
+        return false;
+
+    for (int i = 0; i < a->output_count; i++)
+    {
+        struct e_output_config* output_config = e_config_get_output(b, a->outputs[i].name);
+
+        if (output_config == NULL || output_config->scale != a->outputs[i].scale)
+            return false;
+    }
+
+    return true;
+}
+
+// Parses config file again, and only applies options that changed.
+// Current config is kept if parsing fails.
+static void config_watch_reload(struct e_config_watch* watch)
+{
+    struct e_server* server = watch->server;
+    struct e_config* config = server->config;
+
+    struct e_config new_config = {0};
+    e_config_init(&new_config);
+
+    if (!e_config_parse_config_file(watch->path, &new_config))
+    {
+        e_log_error("config_watch_reload: failed to parse %s, keeping current config", watch->path);
+        e_config_fini(&new_config);
+        return;
+    }
+
+    //repeat info only touches keyboards
+    if (new_config.keyboard.repeat_rate_hz != config->keyboard.repeat_rate_hz || new_config.keyboard.repeat_delay_ms != config->keyboard.repeat_delay_ms)
+    {
+        config->keyboard.repeat_rate_hz = new_config.keyboard.repeat_rate_hz;
+        config->keyboard.repeat_delay_ms = new_config.keyboard.repeat_delay_ms;
+
+        struct e_keyboard* keyboard;
+        wl_list_for_each(keyboard, &server->seat->keyboards, link)
+        {
+            wlr_keyboard_set_repeat_info(keyboard->wlr_keyboard, config->keyboard.repeat_rate_hz, config->keyboard.repeat_delay_ms);
+        }
+
+        e_log_info("config reload: keyboard repeat info changed");
+    }
+
+    //keybinds only rebuild the keybind table, old keybinds are freed with new config
+    if (!e_config_keybinds_equal(config, &new_config))
+    {
+        e_config_swap_keybinds(config, &new_config);
+        e_log_info("config reload: keybinds changed (%i keybinds)", config->keyboard.keybinds.count);
+    }
+
+    //foreign toplevels read the rate limit on every flush
+    if (new_config.foreign_toplevel_max_rate_hz != config->foreign_toplevel_max_rate_hz)
+    {
+        config->foreign_toplevel_max_rate_hz = new_config.foreign_toplevel_max_rate_hz;
+        e_log_info("config reload: foreign toplevel max rate changed to %i", config->foreign_toplevel_max_rate_hz);
+    }
+
+    //hidden view frame timer reads the rate every time it fires
+    if (new_config.hidden_view_frame_rate_hz != config->hidden_view_frame_rate_hz)
+    {
+        config->hidden_view_frame_rate_hz = new_config.hidden_view_frame_rate_hz;
+        e_log_info("config reload: hidden view frame rate changed to %i", config->hidden_view_frame_rate_hz);
+    }
+
+    //cursor reads the delay every time hover focus is scheduled
+    if (new_config.hover_focus_delay_ms != config->hover_focus_delay_ms)
+    {
+        config->hover_focus_delay_ms = new_config.hover_focus_delay_ms;
+        e_log_info("config reload: hover focus delay changed to %i ms", config->hover_focus_delay_ms);
+    }
+
+    //clients are checked against limits on their next commit
+    if (new_config.client_limits.buffer_memory_mb != config->client_limits.buffer_memory_mb || new_config.client_limits.surfaces != config->client_limits.surfaces
+        || new_config.client_limits.kill != config->client_limits.kill)
+    {
+        config->client_limits = new_config.client_limits;
+        e_log_info("config reload: client limits changed");
+    }
+
+    //outputs that didn't change are left alone
+    if (!config_outputs_equal(config, &new_config))
+    {
+        memcpy(config->outputs, new_config.outputs, sizeof(config->outputs));
+        config->output_count = new_config.output_count;
+
+        struct e_output* output;
+        wl_list_for_each(output, &server->outputs, link)
+        {
+            e_output_apply_config(output);
+        }
+
+        e_log_info("config reload: output configuration changed");
+    }
+
+    //tiling mode is runtime state after startup, xwayland can't switch between lazy and immediate once created
+    if (new_config.xwayland_lazy != config->xwayland_lazy)
+        e_log_info("config reload: xwayland_lazy only applies after restarting");
+
+    e_config_fini(&new_config);
+}
+
+static int config_watch_handle_readable(int fd, uint32_t mask, void* data)
+{
+    struct e_config_watch* watch = data;
+
+    _Alignas(struct inotify_event) char buffer[4096];
+    bool changed = false;
+
+    //read all pending events, editors may emit several per save
+    while (true)
+    {
+        ssize_t length = read(fd, buffer, sizeof(buffer));
+
+        if (length <= 0)
+        {
+            if (length < 0 && errno != EAGAIN)
+                e_log_error("config_watch_handle_readable: failed to read inotify events");
+
+            break;
+        }
+
+        ssize_t offset = 0;
+
+        while (offset < length)
+        {
+            struct inotify_event* event = (struct inotify_event*)(buffer + offset);
+
+            if (event->len > 0 && strcmp(event->name, watch->file_name) == 0)
+                changed = true;
+
+            offset += sizeof(struct inotify_event) + event->len;
+        }
+    }
+
+    if (changed)
+        config_watch_reload(watch);
+
+    return 0;
+}
+
+// Starts watching config file at path, reloading server's config when it changes.
+// Returns NULL on fail.
+struct e_config_watch* e_config_watch_create(struct e_server* server, const char* path)
+{
+    assert(server && path);
+
+    if (server == NULL || path == NULL)
+    {
+        e_log_error("e_config_watch_create: server or path is NULL");
+        return NULL;
+    }
+
+    struct e_config_watch* watch = calloc(1, sizeof(*watch));
+
+    if (watch == NULL)
+    {
+        e_log_error("e_config_watch_create: failed to allocate config watch");
+        return NULL;
+    }
+
+    watch->server = server;
+    watch->inotify_fd = -1;
+    watch->path = strdup(path);
+
+    if (watch->path == NULL)
+    {
+        e_log_error("e_config_watch_create: failed to copy path");
+        e_config_watch_destroy(watch);
+        return NULL;
+    }
+
+    //watch directory instead of file, most editors replace the file when saving
+    char* separator = strrchr(watch->path, '/');
+
+    if (separator == NULL)
+    {
+        e_log_error("e_config_watch_create: %s is not a full path", path);
+        e_config_watch_destroy(watch);
+        return NULL;
+    }
+
+    watch->file_name = separator + 1;
+
+    watch->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (watch->inotify_fd < 0)
+    {
+        e_log_error("e_config_watch_create: failed to init inotify");
+        e_config_watch_destroy(watch);
+        return NULL;
+    }
+
+    //temporarily split path into directory path
+    *separator = '\0';
+    int watch_descriptor = inotify_add_watch(watch->inotify_fd, watch->path, IN_CLOSE_WRITE | IN_MOVED_TO);
+    *separator = '/';
+
+    if (watch_descriptor < 0)
+    {
+        e_log_error("e_config_watch_create: failed to watch directory of %s", path);
+        e_config_watch_destroy(watch);
+        return NULL;
+    }
+
+    watch->event_source = wl_event_loop_add_fd(server->event_loop, watch->inotify_fd, WL_EVENT_READABLE, config_watch_handle_readable, watch);
+
+    if (watch->event_source == NULL)
+    {
+        e_log_error("e_config_watch_create: failed to add inotify fd to event loop");
+        e_config_watch_destroy(watch);
+        return NULL;
+    }
+
+    return watch;
+}
+
+void e_config_watch_destroy(struct e_config_watch* watch)
+{
+    assert(watch);
+
+    if (watch == NULL)
+        return;
+
+    if (watch->event_source != NULL)
+        wl_event_source_remove(watch->event_source);
+
+    if (watch->inotify_fd >= 0)
+        close(watch->inotify_fd);
+
+    if (watch->path != NULL)
+        free(watch->path);
+
+    free(watch);
+}
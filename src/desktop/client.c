@@ -0,0 +1,327 @@
+#include "desktop/client.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include <wayland-server-core.h>
+#include <wayland-util.h>
+
+#include <wlr/types/wlr_compositor.h>
+
+#if E_XWAYLAND_SUPPORT
+#include <wlr/xwayland.h>
+#endif
+
+#include "util/log.h"
+#include "util/time.h"
+#include "util/wl_macros.h"
+
+#include "server.h"
+
+// Buffer size estimate per pixel, as most client buffers are 32-bit formats.
+#define BUFFER_BYTES_PER_PIXEL 4
+
+// Surface of a client, for accounting its attached buffer and commits.
+struct client_surface
+{
+    struct wlr_surface* surface;
+
+    // Estimated size of surface's current buffer.
+    uint64_t buffer_bytes;
+
+    struct wl_listener commit;
+    struct wl_listener destroy;
+};
+
+static void client_handle_destroy(struct wl_listener* listener, void* data)
+{
+    struct e_client* client = wl_container_of(listener, client, destroy);
+
+    #if E_VERBOSE
+    e_log_info("client pid %i disconnected: %i surfaces, %i views, %llu KiB of buffers", (int)client->pid, client->surfaces, client->views,
+        (unsigned long long)(client->buffer_bytes / 1024));
+    #endif
+
+    //removed from client's destroy listeners already, surfaces destroyed after this can't find client anymore
+    wl_list_remove(&client->link);
+
+    free(client);
+}
+
+static void server_client_created(struct wl_listener* listener, void* data)
+{
+    struct e_server* server = wl_container_of(listener, server, clients.created);
+    struct wl_client* wl_client = data;
+
+    struct e_client* client = calloc(1, sizeof(*client));
+
+    if (client == NULL)
+    {
+        e_log_error("server_client_created: failed to alloc e_client");
+        return;
+    }
+
+    client->server = server;
+    client->wl_client = wl_client;
+    wl_client_get_credentials(wl_client, &client->pid, NULL, NULL);
+
+    client->destroy.notify = client_handle_destroy;
+    wl_client_add_destroy_listener(wl_client, &client->destroy);
+
+    wl_list_insert(&server->clients.list, &client->link);
+}
+
+// Returns client tracking wayland client.
+// Returns NULL if wayland client isn't tracked or is being destroyed.
+struct e_client* e_client_from_wl_client(struct wl_client* wl_client)
+{
+    if (wl_client == NULL)
+        return NULL;
+
+    struct wl_listener* listener = wl_client_get_destroy_listener(wl_client, client_handle_destroy);
+
+    if (listener == NULL)
+        return NULL;
+
+    struct e_client* client = wl_container_of(listener, client, destroy);
+    return client;
+}
+
+// Returns client owning surface.
+// Returns NULL if client isn't tracked or is being destroyed.
+struct e_client* e_client_from_surface(struct wlr_surface* surface)
+{
+    if (surface == NULL || surface->resource == NULL)
+        return NULL;
+
+    return e_client_from_wl_client(wl_resource_get_client(surface->resource));
+}
+
+// Adds time from start until now to time spent handling client.
+// Client is allowed to be NULL.
+void e_client_add_handler_time(struct e_client* client, const struct timespec* start)
+{
+    assert(start);
+
+    if (client == NULL)
+        return;
+
+    struct timespec now = e_time_now();
+    client->handler_ms += e_time_diff_ms(start, &now);
+}
+
+// Returns true if client is xwayland, which all X11 applications share.
+static bool client_is_xwayland(struct e_client* client)
+{
+    assert(client);
+
+    #if E_XWAYLAND_SUPPORT
+    struct wlr_xwayland* xwayland = client->server->xwayland;
+
+    return (xwayland != NULL && xwayland->server != NULL && xwayland->server->client == client->wl_client);
+    #else
+    return false;
+    #endif
+}
+
+// Warns about clients over their soft limits once, and disconnects them if configured to.
+// Xwayland is never disconnected, as that would take down every X11 application at once.
+static void client_check_limits(struct e_client* client)
+{
+    assert(client);
+
+    struct e_config* config = client->server->config;
+
+    uint64_t memory_limit_bytes = (uint64_t)config->client_limits.buffer_memory_mb * 1024 * 1024;
+    bool over_memory = (memory_limit_bytes > 0 && client->buffer_bytes > memory_limit_bytes);
+    bool over_surfaces = (config->client_limits.surfaces > 0 && client->surfaces > config->client_limits.surfaces);
+
+    if (!over_memory && !over_surfaces)
+    {
+        client->over_limit = false;
+        return;
+    }
+
+    if (!client->over_limit)
+    {
+        client->over_limit = true;
+        e_log_error("client pid %i exceeds soft limits: %llu MiB of buffers, %i surfaces", (int)client->pid,
+            (unsigned long long)(client->buffer_bytes / (1024 * 1024)), client->surfaces);
+
+        if (config->client_limits.kill && client_is_xwayland(client))
+            e_log_error("not disconnecting xwayland for exceeding soft limits");
+    }
+
+    if (config->client_limits.kill && !client->killed && !client_is_xwayland(client))
+    {
+        client->killed = true;
+        e_log_error("disconnecting client pid %i for exceeding soft limits", (int)client->pid);
+
+        //client is disconnected once its current requests are handled
+        wl_client_post_no_memory(client->wl_client);
+    }
+}
+
+static void client_surface_handle_commit(struct wl_listener* listener, void* data)
+{
+    struct client_surface* client_surface = wl_container_of(listener, client_surface, commit);
+    struct wlr_surface* surface = client_surface->surface;
+
+    struct e_client* client = e_client_from_surface(surface);
+
+    uint64_t buffer_bytes = 0;
+
+    if (wlr_surface_has_buffer(surface))
+        buffer_bytes = (uint64_t)surface->current.buffer_width * (uint64_t)surface->current.buffer_height * BUFFER_BYTES_PER_PIXEL;
+
+    if (client != NULL)
+    {
+        client->commits++;
+        client->buffer_bytes = client->buffer_bytes - client_surface->buffer_bytes + buffer_bytes;
+    }
+
+    client_surface->buffer_bytes = buffer_bytes;
+
+    if (client != NULL && buffer_bytes > 0)
+        client_check_limits(client);
+}
+
+static void client_surface_handle_destroy(struct wl_listener* listener, void* data)
+{
+    struct client_surface* client_surface = wl_container_of(listener, client_surface, destroy);
+
+    struct e_client* client = e_client_from_surface(client_surface->surface);
+
+    if (client != NULL)
+    {
+        client->surfaces--;
+        client->buffer_bytes -= client_surface->buffer_bytes;
+    }
+
+    SIGNAL_DISCONNECT(client_surface->commit);
+    SIGNAL_DISCONNECT(client_surface->destroy);
+
+    free(client_surface);
+}
+
+static void server_new_surface(struct wl_listener* listener, void* data)
+{
+    struct wlr_surface* surface = data;
+
+    struct client_surface* client_surface = calloc(1, sizeof(*client_surface));
+
+    if (client_surface == NULL)
+    {
+        e_log_error("server_new_surface: failed to alloc client surface");
+        return;
+    }
+
+    client_surface->surface = surface;
+
+    SIGNAL_CONNECT(surface->events.commit, client_surface->commit, client_surface_handle_commit);
+    SIGNAL_CONNECT(surface->events.destroy, client_surface->destroy, client_surface_handle_destroy);
+
+    struct e_client* client = e_client_from_surface(surface);
+
+    if (client != NULL)
+    {
+        client->surfaces++;
+        client_check_limits(client);
+    }
+}
+
+static int compare_clients_buffer_bytes(const void* a, const void* b)
+{
+    const struct e_client* client_a = *(const struct e_client* const*)a;
+    const struct e_client* client_b = *(const struct e_client* const*)b;
+
+    //most memory first
+    if (client_a->buffer_bytes != client_b->buffer_bytes)
+        return (client_a->buffer_bytes < client_b->buffer_bytes) ? 1 : -1;
+
+    return 0;
+}
+
+// Logs resource usage of all clients, sorted by buffer memory, and resets their rates.
+void e_server_log_clients(struct e_server* server)
+{
+    assert(server);
+
+    struct timespec now = e_time_now();
+    double elapsed_s = e_time_diff_ms(&server->clients.report_time, &now) / 1000.0;
+    server->clients.report_time = now;
+
+    int count = wl_list_length(&server->clients.list);
+
+    if (count == 0)
+    {
+        e_log_info("clients: none connected");
+        return;
+    }
+
+    struct e_client** clients = calloc(count, sizeof(*clients));
+
+    if (clients == NULL)
+    {
+        e_log_error("e_server_log_clients: failed to alloc client array");
+        return;
+    }
+
+    int i = 0;
+    struct e_client* client;
+    wl_list_for_each(client, &server->clients.list, link)
+    {
+        clients[i] = client;
+        i++;
+    }
+
+    qsort(clients, count, sizeof(*clients), compare_clients_buffer_bytes);
+
+    e_log_info("clients: %i connected, rates over last %.1f s", count, elapsed_s);
+
+    for (i = 0; i < count; i++)
+    {
+        client = clients[i];
+
+        e_log_info("client pid %i: %llu KiB of buffers, %i surfaces, %i popups, %i views, %.1f commits/s, %.2f ms in handlers%s", (int)client->pid,
+            (unsigned long long)(client->buffer_bytes / 1024), client->surfaces, client->popups, client->views,
+            (elapsed_s > 0.0) ? client->commits / elapsed_s : 0.0, client->handler_ms, client->over_limit ? " (over limit)" : "");
+
+        client->commits = 0;
+        client->handler_ms = 0.0;
+    }
+
+    free(clients);
+}
+
+// Init tracking of client resources.
+bool e_server_init_clients(struct e_server* server)
+{
+    assert(server && server->display && server->compositor);
+
+    if (server == NULL || server->display == NULL || server->compositor == NULL)
+        return false;
+
+    wl_list_init(&server->clients.list);
+    server->clients.report_time = e_time_now();
+
+    server->clients.created.notify = server_client_created;
+    wl_display_add_client_created_listener(server->display, &server->clients.created);
+
+    SIGNAL_CONNECT(server->compositor->events.new_surface, server->clients.new_surface, server_new_surface);
+
+    return true;
+}
+
+void e_server_fini_clients(struct e_server* server)
+{
+    assert(server);
+
+    if (server == NULL)
+        return;
+
+    SIGNAL_DISCONNECT(server->clients.created);
+    SIGNAL_DISCONNECT(server->clients.new_surface);
+}
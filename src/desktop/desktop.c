@@ -125,3 +125,18 @@ struct e_view_container* e_desktop_focused_view_container(struct e_server* serve
 
     return server->seat->focus.active_view_container;
 }
+
+// Sets desktop's current seat's focus to most recently focused view container of workspace.
+// Clears focus if workspace has no view containers.
+void e_desktop_focus_workspace(struct e_server* server, struct e_workspace* workspace)
+{
+    assert(server && workspace);
+
+    if (workspace == NULL)
+    {
+        e_log_error("e_desktop_focus_workspace: workspace is NULL!");
+        return;
+    }
+
+    e_seat_set_focus_view_container(server->seat, e_workspace_get_recent_view_container(workspace, 0));
+}
@@ -2,6 +2,8 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #include <wayland-server-core.h>
 #include <wayland-util.h>
@@ -9,6 +11,8 @@
 #include <wlr/types/wlr_foreign_toplevel_management_v1.h>
 #include <wlr/types/wlr_ext_foreign_toplevel_list_v1.h>
 
+#include "util/log.h"
+#include "util/time.h"
 #include "util/wl_macros.h"
 
 #include "desktop/views/view.h"
@@ -136,6 +140,167 @@ static void wlr_handle_init(struct e_wlr_foreign_toplevel* wlr_handle, struct e_
 
 /* foreign toplevel */
 
+static bool string_equal(const char* a, const char* b)
+{
+    if (a == NULL || b == NULL)
+        return a == b;
+
+    return strcmp(a, b) == 0;
+}
+
+// Replaces copy with a copy of value, value is allowed to be NULL.
+static void string_replace_copy(char** copy, const char* value)
+{
+    assert(copy);
+
+    free(*copy);
+    *copy = (value != NULL) ? strdup(value) : NULL;
+}
+
+static void foreign_toplevel_flush_state(struct e_foreign_toplevel* foreign_toplevel)
+{
+    assert(foreign_toplevel);
+
+    if (foreign_toplevel->pending.activated && foreign_toplevel->pending.activated_value != foreign_toplevel->sent.activated)
+    {
+        wlr_foreign_toplevel_handle_v1_set_activated(foreign_toplevel->wlr.handle, foreign_toplevel->pending.activated_value);
+        foreign_toplevel->sent.activated = foreign_toplevel->pending.activated_value;
+    }
+
+    if (foreign_toplevel->pending.fullscreen && foreign_toplevel->pending.fullscreen_value != foreign_toplevel->sent.fullscreen)
+    {
+        wlr_foreign_toplevel_handle_v1_set_fullscreen(foreign_toplevel->wlr.handle, foreign_toplevel->pending.fullscreen_value);
+        foreign_toplevel->sent.fullscreen = foreign_toplevel->pending.fullscreen_value;
+    }
+
+    foreign_toplevel->pending.activated = false;
+    foreign_toplevel->pending.fullscreen = false;
+}
+
+static int foreign_toplevel_handle_flush_timer(void* data);
+
+// Returns true if title & app id may be sent now, otherwise arms flush timer for when they may be.
+static bool foreign_toplevel_metadata_rate_allows(struct e_foreign_toplevel* foreign_toplevel, struct timespec* now)
+{
+    assert(foreign_toplevel && now);
+
+    struct e_server* server = foreign_toplevel->ext.view->server;
+    int32_t max_rate_hz = server->config->foreign_toplevel_max_rate_hz;
+
+    if (max_rate_hz <= 0)
+        return true;
+
+    double interval_ms = 1000.0 / max_rate_hz;
+    double elapsed_ms = e_time_diff_ms(&foreign_toplevel->sent.metadata_time, now);
+
+    if (elapsed_ms >= interval_ms)
+        return true;
+
+    if (foreign_toplevel->flush_timer == NULL)
+    {
+        foreign_toplevel->flush_timer = wl_event_loop_add_timer(server->event_loop, foreign_toplevel_handle_flush_timer, foreign_toplevel);
+
+        //can't wait, send now instead of never
+        if (foreign_toplevel->flush_timer == NULL)
+        {
+            e_log_error("foreign_toplevel_metadata_rate_allows: failed to create flush timer");
+            return true;
+        }
+    }
+
+    //round up, so timer never fires before interval has passed
+    wl_event_source_timer_update(foreign_toplevel->flush_timer, (int)(interval_ms - elapsed_ms) + 1);
+
+    return false;
+}
+
+static void foreign_toplevel_flush_metadata(struct e_foreign_toplevel* foreign_toplevel)
+{
+    assert(foreign_toplevel);
+
+    if (!foreign_toplevel->pending.title && !foreign_toplevel->pending.app_id)
+        return;
+
+    struct timespec now = e_time_now();
+
+    if (!foreign_toplevel_metadata_rate_allows(foreign_toplevel, &now))
+        return;
+
+    struct e_ext_foreign_toplevel_state* state = &foreign_toplevel->ext.state;
+
+    bool title_changed = foreign_toplevel->pending.title && !string_equal(state->title, foreign_toplevel->sent.title);
+    bool app_id_changed = foreign_toplevel->pending.app_id && !string_equal(state->app_id, foreign_toplevel->sent.app_id);
+
+    foreign_toplevel->pending.title = false;
+    foreign_toplevel->pending.app_id = false;
+
+    if (!title_changed && !app_id_changed)
+        return;
+
+    if (title_changed)
+    {
+        wlr_foreign_toplevel_handle_v1_set_title(foreign_toplevel->wlr.handle, (state->title != NULL) ? state->title : "");
+        string_replace_copy(&foreign_toplevel->sent.title, state->title);
+    }
+
+    if (app_id_changed)
+    {
+        wlr_foreign_toplevel_handle_v1_set_app_id(foreign_toplevel->wlr.handle, (state->app_id != NULL) ? state->app_id : "");
+        string_replace_copy(&foreign_toplevel->sent.app_id, state->app_id);
+    }
+
+    //ext handle always sends both, so once for all changes
+    ext_handle_update_state(&foreign_toplevel->ext);
+
+    foreign_toplevel->sent.metadata_time = now;
+}
+
+static void foreign_toplevel_flush(struct e_foreign_toplevel* foreign_toplevel)
+{
+    assert(foreign_toplevel);
+
+    foreign_toplevel_flush_state(foreign_toplevel);
+    foreign_toplevel_flush_metadata(foreign_toplevel);
+}
+
+static void foreign_toplevel_handle_flush_idle(void* data)
+{
+    struct e_foreign_toplevel* foreign_toplevel = data;
+
+    foreign_toplevel->flush_idle = NULL;
+
+    foreign_toplevel_flush(foreign_toplevel);
+}
+
+static int foreign_toplevel_handle_flush_timer(void* data)
+{
+    struct e_foreign_toplevel* foreign_toplevel = data;
+
+    foreign_toplevel_flush(foreign_toplevel);
+
+    return 0;
+}
+
+// Sends pending changes once event loop is idle, coalescing all changes until then.
+static void foreign_toplevel_schedule_flush(struct e_foreign_toplevel* foreign_toplevel)
+{
+    assert(foreign_toplevel);
+
+    if (foreign_toplevel->flush_idle != NULL)
+        return;
+
+    struct e_server* server = foreign_toplevel->ext.view->server;
+
+    foreign_toplevel->flush_idle = wl_event_loop_add_idle(server->event_loop, foreign_toplevel_handle_flush_idle, foreign_toplevel);
+
+    //no idle, send immediately so clients don't miss changes
+    if (foreign_toplevel->flush_idle == NULL)
+    {
+        e_log_error("foreign_toplevel_schedule_flush: failed to add idle");
+        foreign_toplevel_flush(foreign_toplevel);
+    }
+}
+
 // Returns NULL on fail.
 struct e_foreign_toplevel* e_foreign_toplevel_create(struct e_view* view)
 {
@@ -152,14 +317,23 @@ struct e_foreign_toplevel* e_foreign_toplevel_create(struct e_view* view)
     if (view->output != NULL)
         e_foreign_toplevel_output_enter(foreign_toplevel, view->output);
 
-    e_foreign_toplevel_set_activated(foreign_toplevel, view->activated);
-    e_foreign_toplevel_set_fullscreen(foreign_toplevel, view->fullscreen);
+    /* initial state is sent immediately, later changes are coalesced */
+
+    wlr_foreign_toplevel_handle_v1_set_activated(foreign_toplevel->wlr.handle, view->activated);
+    wlr_foreign_toplevel_handle_v1_set_fullscreen(foreign_toplevel->wlr.handle, view->fullscreen);
+
+    foreign_toplevel->sent.activated = view->activated;
+    foreign_toplevel->sent.fullscreen = view->fullscreen;
 
     /* ext handle sends state on creation, only send for wlr */
 
     wlr_foreign_toplevel_handle_v1_set_title(foreign_toplevel->wlr.handle, (view->title != NULL) ? view->title : "");
     wlr_foreign_toplevel_handle_v1_set_app_id(foreign_toplevel->wlr.handle, (view->app_id != NULL) ? view->app_id : "");
 
+    string_replace_copy(&foreign_toplevel->sent.title, view->title);
+    string_replace_copy(&foreign_toplevel->sent.app_id, view->app_id);
+    foreign_toplevel->sent.metadata_time = e_time_now();
+
     //TODO: parents, maximized, minimized
 
     return foreign_toplevel;
@@ -184,9 +358,9 @@ void e_foreign_toplevel_set_title(struct e_foreign_toplevel* foreign_toplevel, c
     assert(foreign_toplevel);
 
     foreign_toplevel->ext.state.title = title;
-    ext_handle_update_state(&foreign_toplevel->ext);
+    foreign_toplevel->pending.title = true;
 
-    wlr_foreign_toplevel_handle_v1_set_title(foreign_toplevel->wlr.handle, (title != NULL) ? title : "");
+    foreign_toplevel_schedule_flush(foreign_toplevel);
 }
 
 void e_foreign_toplevel_set_app_id(struct e_foreign_toplevel* foreign_toplevel, const char* app_id)
@@ -194,29 +368,44 @@ void e_foreign_toplevel_set_app_id(struct e_foreign_toplevel* foreign_toplevel,
     assert(foreign_toplevel);
 
     foreign_toplevel->ext.state.app_id = app_id;
-    ext_handle_update_state(&foreign_toplevel->ext);
+    foreign_toplevel->pending.app_id = true;
 
-    wlr_foreign_toplevel_handle_v1_set_app_id(foreign_toplevel->wlr.handle, (app_id != NULL) ? app_id : "");
+    foreign_toplevel_schedule_flush(foreign_toplevel);
 }
 
 void e_foreign_toplevel_set_activated(struct e_foreign_toplevel* foreign_toplevel, bool activated)
 {
     assert(foreign_toplevel);
 
-    wlr_foreign_toplevel_handle_v1_set_activated(foreign_toplevel->wlr.handle, activated);
+    foreign_toplevel->pending.activated = true;
+    foreign_toplevel->pending.activated_value = activated;
+
+    foreign_toplevel_schedule_flush(foreign_toplevel);
 }
 
 void e_foreign_toplevel_set_fullscreen(struct e_foreign_toplevel* foreign_toplevel, bool fullscreen)
 {
     assert(foreign_toplevel);
 
-    wlr_foreign_toplevel_handle_v1_set_fullscreen(foreign_toplevel->wlr.handle, fullscreen);
+    foreign_toplevel->pending.fullscreen = true;
+    foreign_toplevel->pending.fullscreen_value = fullscreen;
+
+    foreign_toplevel_schedule_flush(foreign_toplevel);
 }
 
 void e_foreign_toplevel_destroy(struct e_foreign_toplevel* foreign_toplevel)
 {
     assert(foreign_toplevel);
 
+    if (foreign_toplevel->flush_idle != NULL)
+        wl_event_source_remove(foreign_toplevel->flush_idle);
+
+    if (foreign_toplevel->flush_timer != NULL)
+        wl_event_source_remove(foreign_toplevel->flush_timer);
+
+    free(foreign_toplevel->sent.title);
+    free(foreign_toplevel->sent.app_id);
+
     ext_handle_fini(&foreign_toplevel->ext);
     wlr_handle_fini(&foreign_toplevel->wlr);
 
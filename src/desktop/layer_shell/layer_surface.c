@@ -21,6 +21,7 @@
 #include "input/seat.h"
 
 #include "util/log.h"
+#include "util/trace.h"
 #include "util/wl_macros.h"
 
 #include "server.h"
@@ -164,6 +165,8 @@ static void e_layer_surface_commit(struct wl_listener* listener, void* data)
     struct e_layer_surface* layer_surface = wl_container_of(listener, layer_surface, commit);
     struct wlr_layer_surface_v1* wlr_layer_surface_v1 = layer_surface->scene_layer_surface_v1->layer_surface;
 
+    E_TRACE_BEGIN("e_layer_surface_commit");
+
     bool update_arrangement = false;
 
     //configure on initial commit
@@ -187,6 +190,13 @@ static void e_layer_surface_commit(struct wl_listener* listener, void* data)
         if (layer_tree != NULL)
             wlr_scene_node_reparent(&layer_surface->scene_layer_surface_v1->tree->node, layer_tree);
 
+        //only mapped layer surfaces are in their output's layer lists
+        if (wlr_layer_surface_v1->surface->mapped)
+        {
+            wl_list_remove(&layer_surface->link);
+            wl_list_append(layer_surface->output->layer_surfaces[wlr_layer_surface_v1->current.layer], &layer_surface->link);
+        }
+
         e_log_info("layer surface committed layer");
         update_arrangement = true;
     }
@@ -232,7 +242,9 @@ static void e_layer_surface_commit(struct wl_listener* listener, void* data)
     }
 
     if (update_arrangement)
-        e_output_arrange(layer_surface->output);
+        e_output_arrange_layers(layer_surface->output);
+
+    E_TRACE_END();
 }
 
 // Surface is ready to be displayed.
@@ -244,9 +256,9 @@ static void e_layer_surface_map(struct wl_listener* listener, void* data)
     e_log_info("layer surface mapped!");
     #endif
 
-    wl_list_append(layer_surface->output->layer_surfaces, &layer_surface->link);
+    wl_list_append(layer_surface->output->layer_surfaces[e_layer_surface_get_layer(layer_surface)], &layer_surface->link);
     
-    e_output_arrange(layer_surface->output);
+    e_output_arrange_layers(layer_surface->output);
 
     wlr_scene_node_set_enabled(&layer_surface->scene_layer_surface_v1->tree->node, true);
 
@@ -271,7 +283,7 @@ static void e_layer_surface_unmap(struct wl_listener* listener, void* data)
     if (unmapped_layer_surface->output == NULL)
         return;
     
-    e_output_arrange(unmapped_layer_surface->output);
+    e_output_arrange_layers(unmapped_layer_surface->output);
 
     //get next topmost layer surface that requests exclusive focus, and focus on it
 
@@ -14,6 +14,7 @@
 
 #include <wlr/types/wlr_scene.h>
 #include <wlr/types/wlr_output.h>
+#include <wlr/types/wlr_output_management_v1.h>
 #include <wlr/types/wlr_screencopy_v1.h>
 #include <wlr/types/wlr_export_dmabuf_v1.h>
 #include <wlr/types/wlr_ext_image_capture_source_v1.h>
@@ -24,18 +25,55 @@
 #include "wlr-layer-shell-unstable-v1-protocol.h"
 
 #include "desktop/tree/workspace.h"
+#include "desktop/views/view.h"
 #include "desktop/desktop.h"
 #include "desktop/layer_shell.h"
 
+#include "input/cursor.h"
+#include "input/seat.h"
+
 #include "util/list.h"
 #include "util/log.h"
+#include "util/time.h"
+#include "util/watchdog.h"
 #include "util/wl_macros.h"
 
 #include "protocols/cosmic-workspace-v1.h"
 #include "protocols/ext-workspace-v1.h"
 
+#if E_XWAYLAND_SUPPORT
+#include "desktop/xwayland.h"
+#endif
+
 #include "server.h"
 
+// Counts whether cursor was on a hardware plane or composited in presented frame.
+static void output_update_cursor_stats(struct e_output* output)
+{
+    struct wlr_output* wlr_output = output->wlr_output;
+
+    struct wlr_output_cursor* output_cursor;
+    wl_list_for_each(output_cursor, &wlr_output->cursors, link)
+    {
+        if (!output_cursor->enabled || !output_cursor->visible)
+            continue;
+
+        bool hardware = (wlr_output->hardware_cursor == output_cursor);
+
+        if (hardware)
+            output->cursor_stats.hardware_frames++;
+        else
+            output->cursor_stats.composited_frames++;
+
+        #if E_VERBOSE
+        if (hardware != output->cursor_stats.hardware)
+            e_log_info("output %s: cursor is %s", wlr_output->name, hardware ? "on a hardware plane" : "composited");
+        #endif
+
+        output->cursor_stats.hardware = hardware;
+    }
+}
+
 static void e_output_frame(struct wl_listener* listener, void* data)
 {
     struct e_output* output = wl_container_of(listener, output, frame);
@@ -43,13 +81,37 @@ static void e_output_frame(struct wl_listener* listener, void* data)
     if (output->scene_output == NULL)
         return;
 
+    e_watchdog_section_begin("output frame");
+
+    //drag icon & sloppy focus follow cursor once per frame
+    e_seat_update_drag_icon(output->server->seat);
+    e_cursor_flush_focus_hover(output->server->seat->cursor);
+
     //render scene output viewport, commit its output to show it, and send frame from this timestamp
-    wlr_scene_output_commit(output->scene_output, NULL);
+    bool committed = wlr_scene_output_commit(output->scene_output, NULL);
+
+    if (committed && !output->server->startup.first_frame)
+        e_server_handle_output_frame(output->server);
+
+    if (committed)
+        output_update_cursor_stats(output);
+
+    if (committed && output->workspace_switch_pending)
+    {
+        output->workspace_switch_pending = false;
+
+        #if E_VERBOSE
+        struct timespec frame_time = e_time_now();
+        e_log_info("output %s: workspace switch to frame took %.2f ms", output->wlr_output->name, e_time_diff_ms(&output->workspace_switch_time, &frame_time));
+        #endif
+    }
 
     //send frame from this timestamp
     struct timespec now;
     clock_gettime(CLOCK_MONOTONIC, &now);
     wlr_scene_output_send_frame_done(output->scene_output, &now);
+
+    e_watchdog_section_end();
 }
 
 static void e_output_request_state(struct wl_listener* listener, void* data)
@@ -61,9 +123,167 @@ static void e_output_request_state(struct wl_listener* listener, void* data)
 
     //rearrange output accordingly to the new output buffer on commit success
     if (wlr_output_commit_state(output->wlr_output, event->state))
+    {
         e_output_arrange(output);
+
+        //scale may have changed
+        if (output->server->seat != NULL)
+            e_cursor_load_scale(output->server->seat->cursor, output->wlr_output->scale);
+    }
     else 
+    {
         e_log_error("Failed to commit output request state");
+    }
+}
+
+/* hotplug */
+
+// Time without output hotplugs before outputs are arranged, docks bring up several outputs within milliseconds.
+#define HOTPLUG_SETTLE_MS 150
+
+static int server_hotplug_settled(void* data)
+{
+    struct e_server* server = data;
+
+    int arranged = 0;
+
+    struct e_output* output;
+    wl_list_for_each(output, &server->outputs, link)
+    {
+        //disabled outputs aren't displayed
+        if (output->scene_output == NULL)
+            continue;
+
+        e_output_arrange(output);
+        arranged++;
+    }
+
+    int avoided = server->hotplug.arranges_requested - arranged;
+
+    e_log_info("outputs settled: %i added, %i removed, %i output arranges avoided", server->hotplug.outputs_added, server->hotplug.outputs_removed, (avoided > 0) ? avoided : 0);
+
+    server->hotplug.outputs_added = 0;
+    server->hotplug.outputs_removed = 0;
+    server->hotplug.arranges_requested = 0;
+
+    return 0;
+}
+
+// Output was added or removed.
+// At runtime outputs are arranged once hotplugs settle, while starting up they're arranged immediately.
+static void server_output_hotplugged(struct e_server* server, bool added)
+{
+    //outputs being destroyed while server stops don't affect other outputs
+    if (!added && !server->running)
+        return;
+
+    if (!server->running || server->hotplug.settle_timer == NULL)
+    {
+        struct e_output* output;
+        wl_list_for_each(output, &server->outputs, link)
+        {
+            if (output->scene_output != NULL)
+                e_output_arrange(output);
+        }
+
+        return;
+    }
+
+    if (added)
+        server->hotplug.outputs_added++;
+    else
+        server->hotplug.outputs_removed++;
+
+    //without settling every displayed output would be arranged right now
+    struct e_output* output;
+    wl_list_for_each(output, &server->outputs, link)
+    {
+        if (output->scene_output != NULL)
+            server->hotplug.arranges_requested++;
+    }
+
+    //restart window
+    wl_event_source_timer_update(server->hotplug.settle_timer, HOTPLUG_SETTLE_MS);
+}
+
+// Returns output that containers of output are moved to when it is removed.
+// Returns NULL if there is none.
+static struct e_output* output_find_migration_target(struct e_output* output)
+{
+    struct e_output* target;
+    wl_list_for_each(target, &output->server->outputs, link)
+    {
+        //disabled outputs aren't displayed
+        if (target != output && target->scene_output != NULL)
+            return target;
+    }
+
+    return NULL;
+}
+
+// Moves containers of output's workspaces to the same workspace slots of another output.
+// Inactive target workspaces are arranged right away, the active one is left dirty for the caller to arrange.
+static void output_migrate_containers(struct e_output* output)
+{
+    struct e_output* target = output_find_migration_target(output);
+
+    if (target == NULL)
+        return;
+
+    struct wlr_box full_area = (struct wlr_box){0, 0, 0, 0};
+    wlr_output_layout_get_box(target->layout, target->wlr_output, &full_area);
+
+    for (int i = 0; i < E_OUTPUT_WORKSPACE_SLOTS; i++)
+    {
+        struct e_workspace* workspace = output->workspace_group.workspaces[i];
+
+        if (workspace == NULL || e_workspace_is_empty(workspace))
+            continue;
+
+        struct e_workspace* target_workspace = e_output_get_workspace(target, i);
+
+        if (target_workspace == NULL)
+        {
+            e_log_error("output_migrate_containers: failed to get workspace %i of output %s", i, target->wlr_output->name);
+            continue;
+        }
+
+        e_workspace_move_containers(workspace, target_workspace);
+
+        //area of target already matches, so it wouldn't be arranged before it is displayed
+        if (!target_workspace->active)
+            e_workspace_arrange(target_workspace, full_area, target->usable_area);
+    }
+}
+
+// Moves seat focus off surfaces of output that won't be displayed anymore.
+static void output_move_focus_off(struct e_output* output)
+{
+    struct e_seat* seat = output->server->seat;
+
+    if (seat == NULL)
+        return;
+
+    if (seat->focus.focused_layer_surface != NULL && seat->focus.focused_layer_surface->output == output)
+        e_seat_set_focus_layer_surface(seat, NULL);
+
+    struct e_view_container* view_container = seat->focus.active_view_container;
+
+    if (view_container == NULL || view_container->base.workspace == NULL)
+        return;
+
+    struct e_workspace* workspace = view_container->base.workspace;
+
+    //still displayed, possibly migrated to the active workspace of another output
+    if (workspace->active && workspace->output != output)
+        return;
+
+    struct e_output* target = output_find_migration_target(output);
+
+    if (target != NULL && target->active_workspace != NULL)
+        e_seat_set_focus_view_container(seat, e_workspace_get_recent_view_container(target->active_workspace, 0));
+    else
+        e_seat_set_focus_view_container(seat, NULL);
 }
 
 static void output_fini_workspaces(struct e_output* output)
@@ -73,19 +293,39 @@ static void output_fini_workspaces(struct e_output* output)
     if (output == NULL)
         return;
 
+    //keep views of unplugged outputs, everything is destroyed anyway once server stops
+    if (output->server->running)
+    {
+        output_migrate_containers(output);
+        output_move_focus_off(output);
+    }
+
     if (output->active_workspace != NULL)
         e_output_display_workspace(output, NULL);
 
     //destroy all workspaces
-    for (int i = 0; i < output->workspace_group.workspaces.count; i++)
+    for (int i = 0; i < E_OUTPUT_WORKSPACE_SLOTS; i++)
     {
-        struct e_workspace* workspace = e_list_at(&output->workspace_group.workspaces, i);
+        struct e_workspace* workspace = output->workspace_group.workspaces[i];
         
         if (workspace != NULL)
             e_workspace_destroy(workspace);
+
+        output->workspace_group.workspaces[i] = NULL;
     }
 
-    e_list_fini(&output->workspace_group.workspaces);
+    //destroying workspaces may have scheduled a reclaim
+    if (output->workspace_group.reclaim_idle != NULL)
+    {
+        wl_event_source_remove(output->workspace_group.reclaim_idle);
+        output->workspace_group.reclaim_idle = NULL;
+    }
+
+    if (output->workspace_group.arrange_idle != NULL)
+    {
+        wl_event_source_remove(output->workspace_group.arrange_idle);
+        output->workspace_group.arrange_idle = NULL;
+    }
 
     e_cosmic_workspace_group_output_leave(output->workspace_group.cosmic_handle, output->wlr_output);
     e_cosmic_workspace_group_remove(output->workspace_group.cosmic_handle);
@@ -98,6 +338,13 @@ static void e_output_handle_destroy(struct wl_listener* listener, void* data)
 {
     struct e_output* output = wl_container_of(listener, output, destroy);
 
+    #if E_VERBOSE
+    e_log_info("output %s: cursor on hardware plane in %llu frames, composited in %llu frames", output->wlr_output->name,
+        (unsigned long long)output->cursor_stats.hardware_frames, (unsigned long long)output->cursor_stats.composited_frames);
+    e_log_info("output %s: layer surfaces caused %llu workspace relayouts, %llu skipped", output->wlr_output->name,
+        (unsigned long long)output->layer_arrange_stats.relayouts, (unsigned long long)output->layer_arrange_stats.skips);
+    #endif
+
     output_fini_workspaces(output);
 
     wlr_scene_node_destroy(&output->tree->node);
@@ -122,6 +369,9 @@ static void e_output_handle_destroy(struct wl_listener* listener, void* data)
     wl_list_remove(&output->link);
 
     output->wlr_output->data = NULL;
+
+    //remaining outputs may have moved & received containers
+    server_output_hotplugged(output->server, false);
     
     free(output);
 }
@@ -150,7 +400,8 @@ struct e_output* e_output_create(struct wlr_output* wlr_output)
     output->usable_area = (struct wlr_box){0, 0, 0, 0};
 
     wl_list_init(&output->link);
-    wl_list_init(&output->layer_surfaces);
+    for (int i = 0; i < E_OUTPUT_LAYERS; i++)
+        wl_list_init(&output->layer_surfaces[i]);
 
     wlr_output->data = output;
 
@@ -163,57 +414,183 @@ struct e_output* e_output_create(struct wlr_output* wlr_output)
     return output;
 }
 
-static void e_output_arrange_layer(struct e_output* output, enum zwlr_layer_shell_v1_layer layer, struct wlr_box* full_area, struct wlr_box* remaining_area)
+// Configures all layer surfaces in one pass from the top layer down, each one updating remaining area.
+static void e_output_arrange_all_layers(struct e_output* output, struct wlr_box* full_area, struct wlr_box* remaining_area)
 {
     assert(output && full_area && remaining_area);
 
-    if (wl_list_empty(&output->layer_surfaces))
-        return;
-
-    //configure each layer surface in this output & layer
-    struct e_layer_surface* layer_surface;
-    wl_list_for_each(layer_surface, &output->layer_surfaces, link)
+    for (int layer = ZWLR_LAYER_SHELL_V1_LAYER_OVERLAY; layer >= ZWLR_LAYER_SHELL_V1_LAYER_BACKGROUND; layer--)
     {
-        //is this surface on this output & layer? if so, then configure and update remaining area
-        if (e_layer_surface_get_layer(layer_surface) == layer)
+        struct e_layer_surface* layer_surface;
+        wl_list_for_each(layer_surface, &output->layer_surfaces[layer], link)
+        {
             e_layer_surface_configure(layer_surface, full_area, remaining_area);
+        }
     }
 }
 
-static void e_output_arrange_all_layers(struct e_output* output, struct wlr_box* full_area, struct wlr_box* remaining_area)
+// Get topmost layer surface that requests exclusive focus.
+// Returns NULL if none.
+struct e_layer_surface* e_output_get_exclusive_topmost_layer_surface(struct e_output* output)
 {
-    assert(output && full_area && remaining_area);
+    //highest layer lives
+    for (int layer = ZWLR_LAYER_SHELL_V1_LAYER_OVERLAY; layer >= ZWLR_LAYER_SHELL_V1_LAYER_BACKGROUND; layer--)
+    {
+        struct e_layer_surface* layer_surface;
+        wl_list_for_each(layer_surface, &output->layer_surfaces[layer], link)
+        {
+            //must request exclusive focus
+            if (layer_surface->scene_layer_surface_v1->layer_surface->current.keyboard_interactive == ZWLR_LAYER_SURFACE_V1_KEYBOARD_INTERACTIVITY_EXCLUSIVE)
+                return layer_surface;
+        }
+    }
 
-    e_output_arrange_layer(output, ZWLR_LAYER_SHELL_V1_LAYER_OVERLAY, full_area, remaining_area);
-    e_output_arrange_layer(output, ZWLR_LAYER_SHELL_V1_LAYER_TOP, full_area, remaining_area);
-    e_output_arrange_layer(output, ZWLR_LAYER_SHELL_V1_LAYER_BOTTOM, full_area, remaining_area);
-    e_output_arrange_layer(output, ZWLR_LAYER_SHELL_V1_LAYER_BACKGROUND, full_area, remaining_area);
+    return NULL;
 }
 
-// Get topmost layer surface that requests exclusive focus.
-// Returns NULL if none.
-struct e_layer_surface* e_output_get_exclusive_topmost_layer_surface(struct e_output* output)
+// Returns workspace in slot index of output, creating it if it doesn't exist yet.
+// Returns NULL on fail.
+struct e_workspace* e_output_get_workspace(struct e_output* output, int index)
 {
-    if (wl_list_empty(&output->layer_surfaces))
+    assert(output);
+
+    if (output == NULL)
+    {
+        e_log_error("e_output_get_workspace: no output given!");
         return NULL;
+    }
 
-    struct e_layer_surface* topmost_layer_surface = NULL;
-    struct e_layer_surface* layer_surface;
+    if (index < 0 || index >= E_OUTPUT_WORKSPACE_SLOTS)
+    {
+        e_log_error("e_output_get_workspace: index %i out of bounds", index);
+        return NULL;
+    }
 
-    wl_list_for_each(layer_surface, &output->layer_surfaces, link)
+    if (output->workspace_group.workspaces[index] != NULL)
+        return output->workspace_group.workspaces[index];
+
+    //create on demand, advertised to workspace protocol clients from here on
+    struct e_workspace* workspace = e_workspace_create(output);
+
+    if (workspace == NULL)
     {
-        struct wlr_layer_surface_v1* wlr_layer_surface_v1 = layer_surface->scene_layer_surface_v1->layer_surface;
+        e_log_error("e_output_get_workspace: failed to create workspace %i", index + 1);
+        return NULL;
+    }
+
+    //give number names
+    char name[16];
+    snprintf(name, sizeof(name), "%i", index + 1);
+    e_workspace_set_name(workspace, name);
+
+    //coords keep pagers ordered, even though workspaces appear out of order
+    e_workspace_set_coords(workspace, (uint32_t)index);
 
-        //must request exclusive focus
-        if (wlr_layer_surface_v1->current.keyboard_interactive != ZWLR_LAYER_SURFACE_V1_KEYBOARD_INTERACTIVITY_EXCLUSIVE)
+    output->workspace_group.workspaces[index] = workspace;
+
+    //keep layout ready for when it is displayed
+    struct wlr_box full_area = (struct wlr_box){0, 0, 0, 0};
+    wlr_output_layout_get_box(output->layout, output->wlr_output, &full_area);
+    e_workspace_arrange(workspace, full_area, output->usable_area);
+
+    #if E_VERBOSE
+    e_log_info("created workspace %i on output %s", index + 1, output->wlr_output->name);
+    #endif
+
+    return workspace;
+}
+
+// Returns slot index of workspace in output.
+// Returns -1 if not found.
+int e_output_get_workspace_index(struct e_output* output, struct e_workspace* workspace)
+{
+    assert(output);
+
+    if (output == NULL || workspace == NULL)
+        return -1;
+
+    for (int i = 0; i < E_OUTPUT_WORKSPACE_SLOTS; i++)
+    {
+        if (output->workspace_group.workspaces[i] == workspace)
+            return i;
+    }
+
+    return -1;
+}
+
+static void output_idle_reclaim_workspaces(void* data)
+{
+    struct e_output* output = data;
+
+    output->workspace_group.reclaim_idle = NULL;
+
+    for (int i = 0; i < E_OUTPUT_WORKSPACE_SLOTS; i++)
+    {
+        struct e_workspace* workspace = output->workspace_group.workspaces[i];
+
+        if (workspace == NULL || workspace->active || !e_workspace_is_empty(workspace))
+            continue;
+
+        #if E_VERBOSE
+        e_log_info("reclaiming empty workspace %i on output %s", i + 1, output->wlr_output->name);
+        #endif
+
+        e_workspace_destroy(workspace);
+        output->workspace_group.workspaces[i] = NULL;
+    }
+}
+
+// Schedules destroying output's empty & inactive workspaces once event loop is idle.
+void e_output_schedule_workspace_reclaim(struct e_output* output)
+{
+    assert(output);
+
+    if (output == NULL || output->workspace_group.reclaim_idle != NULL)
+        return;
+
+    //not immediately, workspaces are still used after containers leave them until they're arranged
+    output->workspace_group.reclaim_idle = wl_event_loop_add_idle(output->server->event_loop, output_idle_reclaim_workspaces, output);
+
+    if (output->workspace_group.reclaim_idle == NULL)
+        e_log_error("e_output_schedule_workspace_reclaim: failed to add idle event");
+}
+
+static void output_idle_arrange_inactive_workspaces(void* data)
+{
+    struct e_output* output = data;
+
+    output->workspace_group.arrange_idle = NULL;
+
+    if (output->layout == NULL)
+        return;
+
+    struct wlr_box full_area = (struct wlr_box){0, 0, 0, 0};
+    wlr_output_layout_get_box(output->layout, output->wlr_output, &full_area);
+
+    for (int i = 0; i < E_OUTPUT_WORKSPACE_SLOTS; i++)
+    {
+        struct e_workspace* workspace = output->workspace_group.workspaces[i];
+
+        if (workspace == NULL || workspace->active)
             continue;
 
-        //highest layer lives
-        if (topmost_layer_surface == NULL || wlr_layer_surface_v1->current.layer > e_layer_surface_get_layer(topmost_layer_surface))
-            topmost_layer_surface = layer_surface;
+        if (workspace->dirty || !wlr_box_equal(&workspace->full_area, &full_area) || !wlr_box_equal(&workspace->tiled_area, &output->usable_area))
+            e_workspace_arrange(workspace, full_area, output->usable_area);
     }
+}
+
+// Schedules arranging output's inactive workspaces in the background, so displaying them doesn't have to.
+void e_output_schedule_inactive_workspaces_arrange(struct e_output* output)
+{
+    assert(output);
+
+    if (output->workspace_group.arrange_idle != NULL)
+        return;
 
-    return topmost_layer_surface;
+    output->workspace_group.arrange_idle = wl_event_loop_add_idle(output->server->event_loop, output_idle_arrange_inactive_workspaces, output);
+
+    if (output->workspace_group.arrange_idle == NULL)
+        e_log_error("e_output_schedule_inactive_workspaces_arrange: failed to add idle event");
 }
 
 // Display given workspace.
@@ -233,27 +610,137 @@ bool e_output_display_workspace(struct e_output* output, struct e_workspace* wor
         return false;
     }
 
-    //deactivate previous workspace
+    //deactivate previous workspace, and reclaim it if nothing is left on it
     if (output->active_workspace != NULL)
+    {
         e_workspace_set_activated(output->active_workspace, false);
 
+        if (e_workspace_is_empty(output->active_workspace))
+            e_output_schedule_workspace_reclaim(output);
+    }
+
     //activate new workspace
 
     output->active_workspace = workspace;
 
     if (workspace != NULL)
     {
+        output->workspace_switch_time = e_time_now();
+        output->workspace_switch_pending = true;
+
         e_workspace_set_activated(workspace, true);
 
         struct wlr_box full_area = (struct wlr_box){0, 0, 0, 0};
         wlr_output_layout_get_box(output->layout, output->wlr_output, &full_area);
-        e_workspace_arrange(workspace, full_area, output->usable_area);
+
+        //inactive workspaces are arranged in the background, so usually displaying only has to enable its trees
+        if (workspace->dirty || !wlr_box_equal(&workspace->full_area, &full_area) || !wlr_box_equal(&workspace->tiled_area, &output->usable_area))
+            e_workspace_arrange(workspace, full_area, output->usable_area);
     }
 
     return true;
 }
 
-void e_output_arrange(struct e_output* output)
+// Places enabled output at x, y in layout, or removes disabled output from layout.
+// Returns true on success, false on fail.
+bool e_output_update_layout(struct e_output* output, bool enabled, int x, int y)
+{
+    assert(output && output->server);
+
+    if (output == NULL || output->server == NULL)
+        return false;
+
+    struct e_server* server = output->server;
+
+    if (!enabled)
+    {
+        //keep views of disabled outputs reachable, like those of unplugged outputs
+        if (output->scene_output != NULL && server->running)
+        {
+            output_migrate_containers(output);
+            output_move_focus_off(output);
+        }
+
+        //scene output layout destroys its scene output along with it
+        wlr_output_layout_remove(server->output_layout, output->wlr_output);
+        output->scene_output = NULL;
+
+        //layer surfaces would otherwise show up on outputs placed over its old area
+        wlr_scene_node_set_enabled(&output->tree->node, false);
+
+        return true;
+    }
+
+    //only moves output if it is already in layout
+    struct wlr_output_layout_output* layout_output = wlr_output_layout_add(server->output_layout, output->wlr_output, x, y);
+
+    if (layout_output == NULL)
+    {
+        e_log_error("e_output_update_layout: failed to add output to layout");
+        return false;
+    }
+
+    //output was disabled before
+    if (output->scene_output == NULL)
+    {
+        output->scene_output = wlr_scene_output_create(server->scene, output->wlr_output);
+
+        if (output->scene_output == NULL)
+        {
+            e_log_error("e_output_update_layout: failed to create scene output");
+            wlr_output_layout_remove(server->output_layout, output->wlr_output);
+            return false;
+        }
+
+        wlr_scene_output_layout_add_output(server->scene_layout, layout_output, output->scene_output);
+        wlr_scene_node_set_enabled(&output->tree->node, true);
+
+        //views of its active workspace were hidden with it
+        e_view_flush_deferred_commits(server);
+    }
+
+    return true;
+}
+
+// Applies output's configuration in server's config, or defaults if it isn't configured.
+void e_output_apply_config(struct e_output* output)
+{
+    assert(output);
+
+    if (output == NULL)
+        return;
+
+    struct e_output_config* output_config = e_config_get_output(output->server->config, output->wlr_output->name);
+    float scale = (output_config != NULL) ? output_config->scale : 1.0f;
+
+    if (output->wlr_output->scale == scale)
+        return;
+
+    struct wlr_output_state state;
+    wlr_output_state_init(&state);
+    wlr_output_state_set_scale(&state, scale);
+
+    bool committed = wlr_output_commit_state(output->wlr_output, &state);
+    wlr_output_state_finish(&state);
+
+    if (!committed)
+    {
+        e_log_error("e_output_apply_config: failed to set scale of output %s to %.2f", output->wlr_output->name, scale);
+        return;
+    }
+
+    e_log_info("output %s: scale set to %.2f", output->wlr_output->name, scale);
+
+    //logical size of output changed
+    e_output_arrange(output);
+
+    if (output->server->seat != NULL)
+        e_cursor_load_scale(output->server->seat->cursor, scale);
+}
+
+// Arranges layer surfaces, then active workspace in the area left by their exclusive zones.
+// If not forced, workspaces are only rearranged if that area changed.
+static void output_arrange(struct e_output* output, bool force_workspaces)
 {
     assert(output && output->layout);
 
@@ -268,6 +755,20 @@ void e_output_arrange(struct e_output* output)
 
     e_output_arrange_all_layers(output, &full_area, &remaining_area);
 
+    if (!force_workspaces)
+    {
+        //layer surfaces that didn't change any exclusive zone, like notifications and osds, don't affect views
+        bool full_area_changed = (output->active_workspace != NULL && !wlr_box_equal(&full_area, &output->active_workspace->full_area));
+
+        if (!full_area_changed && wlr_box_equal(&remaining_area, &output->usable_area))
+        {
+            output->layer_arrange_stats.skips++;
+            return;
+        }
+
+        output->layer_arrange_stats.relayouts++;
+    }
+
     if (output->active_workspace != NULL)
         e_workspace_arrange(output->active_workspace, full_area, remaining_area);
     
@@ -277,6 +778,26 @@ void e_output_arrange(struct e_output* output)
     #endif
 
     output->usable_area = remaining_area;
+
+    #if E_XWAYLAND_SUPPORT
+    //x11 clients place themselves using workareas
+    if (output->server->xwayland != NULL)
+        e_server_update_xwayland_workareas(output->server);
+    #endif
+
+    //keep inactive workspaces' layouts valid
+    e_output_schedule_inactive_workspaces_arrange(output);
+}
+
+void e_output_arrange(struct e_output* output)
+{
+    output_arrange(output, true);
+}
+
+// Arranges layer surfaces of output, only rearranging its active workspace if the area left for it changed.
+void e_output_arrange_layers(struct e_output* output)
+{
+    output_arrange(output, false);
 }
 
 // Destroy the output.
@@ -288,11 +809,11 @@ void e_output_destroy(struct e_output* output)
         wlr_output_destroy(output->wlr_output);
 }
 
-static void output_init_mode(struct wlr_output* output)
+static void output_init_mode(struct wlr_output* output, struct e_config* config)
 {
-    assert(output);
+    assert(output && config);
 
-    if (output == NULL)
+    if (output == NULL || config == NULL)
         return;
 
     //enable state if neccessary
@@ -306,6 +827,12 @@ static void output_init_mode(struct wlr_output* output)
     if (!wl_list_empty(&output->modes))
         wlr_output_state_set_mode(&state, mode);
 
+    //fractional scales are fine, clients are told the exact scale to render at
+    struct e_output_config* output_config = e_config_get_output(config, output->name);
+
+    if (output_config != NULL)
+        wlr_output_state_set_scale(&state, output_config->scale);
+
     //apply new output state
     wlr_output_commit_state(output, &state);
     wlr_output_state_finish(&state);    
@@ -384,27 +911,18 @@ static bool output_init_workspaces(struct e_output* output)
     output->workspace_group.ext_handle = e_ext_workspace_group_create(output->server->ext_workspace_manager);
     e_ext_workspace_group_output_enter(output->workspace_group.ext_handle, output->wlr_output);
 
-    //create 5 workspaces for output
-    e_list_init(&output->workspace_group.workspaces, 5);
+    //other workspaces are created on demand
+    struct e_workspace* workspace = e_output_get_workspace(output, 0);
 
-    for (int i = 0; i < 5; i++)
+    if (workspace == NULL)
     {
-        struct e_workspace* workspace = e_workspace_create(output);
-
-        //give number names
-        char name[16];
-        snprintf(name, sizeof(name), "%i", i + 1);
-        e_workspace_set_name(workspace, name);
-
-        if (workspace != NULL)
-            e_list_add(&output->workspace_group.workspaces, workspace);
-        else
-            e_log_error("e_output_init_workspaces: failed to create workspace %i", i + 1);
+        e_log_error("e_output_init_workspaces: failed to create first workspace");
+        return false;
     }
 
-    e_output_display_workspace(output, e_list_at(&output->workspace_group.workspaces, 0));
+    e_output_display_workspace(output, workspace);
 
-    e_output_arrange(output);
+    //arranged once hotplugs settled
 
     return true;
 }
@@ -429,7 +947,7 @@ static void server_new_output(struct wl_listener* listener, void* data)
         return;
     }
 
-    output_init_mode(wlr_output);
+    output_init_mode(wlr_output, server->config);
 
     //allocate & configure output
     struct e_output* output = e_output_create(wlr_output);
@@ -458,7 +976,237 @@ static void server_new_output(struct wl_listener* listener, void* data)
         return;
     }
 
-    //TODO: update xwayland workarea
+    //cursor images are ready before cursor enters output
+    if (server->seat != NULL)
+        e_cursor_load_scale(server->seat->cursor, wlr_output->scale);
+
+    //arranging output updates xwayland workareas
+    server_output_hotplugged(server, true);
+}
+
+/* output management */
+
+static void server_output_manager_update_idle(void* data)
+{
+    struct e_server* server = data;
+    server->output_manager_update_idle = NULL;
+
+    struct wlr_output_configuration_v1* config = wlr_output_configuration_v1_create();
+
+    if (config == NULL)
+    {
+        e_log_error("server_output_manager_update_idle: failed to create output configuration");
+        return;
+    }
+
+    struct e_output* output;
+    wl_list_for_each(output, &server->outputs, link)
+    {
+        //fills in current state of output, except for its position
+        struct wlr_output_configuration_head_v1* head = wlr_output_configuration_head_v1_create(config, output->wlr_output);
+
+        if (head == NULL)
+        {
+            e_log_error("server_output_manager_update_idle: failed to create output configuration head");
+            continue;
+        }
+
+        struct wlr_box box;
+        wlr_output_layout_get_box(server->output_layout, output->wlr_output, &box);
+
+        //disabled outputs aren't in layout
+        if (!wlr_box_empty(&box))
+        {
+            head->state.x = box.x;
+            head->state.y = box.y;
+        }
+    }
+
+    //takes ownership of config
+    wlr_output_manager_v1_set_configuration(server->output_manager, config);
+}
+
+// Sends current configuration to output management clients once event loop is idle, so batched changes are sent once.
+static void server_output_manager_schedule_update(struct e_server* server)
+{
+    if (server->output_manager == NULL || server->output_manager_update_idle != NULL)
+        return;
+
+    server->output_manager_update_idle = wl_event_loop_add_idle(server->event_loop, server_output_manager_update_idle, server);
+}
+
+static void server_output_layout_change(struct wl_listener* listener, void* data)
+{
+    struct e_server* server = wl_container_of(listener, server, output_layout_change);
+
+    server_output_manager_schedule_update(server);
+}
+
+// Returns true if applying head would change mode, scale, transform, position or enabled state of its output.
+static bool output_config_head_changes(struct wlr_output_configuration_head_v1* head)
+{
+    struct wlr_output* wlr_output = head->state.output;
+    struct e_output* output = wlr_output->data;
+
+    //scene output is only kept for outputs in layout
+    bool enabled = (output != NULL) ? (output->scene_output != NULL) : wlr_output->enabled;
+
+    if (head->state.enabled != enabled)
+        return true;
+
+    //disabled outputs stay disabled
+    if (!head->state.enabled)
+        return false;
+
+    if (head->state.mode != NULL)
+    {
+        if (head->state.mode != wlr_output->current_mode)
+            return true;
+    }
+    else if (head->state.custom_mode.width != wlr_output->width || head->state.custom_mode.height != wlr_output->height || head->state.custom_mode.refresh != wlr_output->refresh)
+    {
+        return true;
+    }
+
+    if (head->state.scale != wlr_output->scale || head->state.transform != wlr_output->transform)
+        return true;
+
+    if (output == NULL)
+        return false;
+
+    struct wlr_box box;
+    wlr_output_layout_get_box(output->layout, wlr_output, &box);
+
+    return (head->state.x != box.x || head->state.y != box.y);
+}
+
+// Tests all heads of config as a single batch, and if not test only applies them with a single backend commit.
+// Every changed output and every output containers were migrated to is arranged once after.
+// Returns true on success, false on fail.
+static bool server_apply_output_config(struct e_server* server, struct wlr_output_configuration_v1* config, bool test_only)
+{
+    size_t states_len = 0;
+    struct wlr_backend_output_state* states = wlr_output_configuration_v1_build_state(config, &states_len);
+
+    if (states == NULL)
+    {
+        e_log_error("server_apply_output_config: failed to build output states");
+        return false;
+    }
+
+    //outputs to arrange, mark them before commit changes their state
+    if (!test_only)
+    {
+        struct wlr_output_configuration_head_v1* head;
+        wl_list_for_each(head, &config->heads, link)
+        {
+            struct e_output* output = head->state.output->data;
+
+            if (output != NULL)
+                output->config_changed = output_config_head_changes(head);
+        }
+    }
+
+    //nothing is touched unless the whole batch can be applied
+    bool success = wlr_backend_test(server->backend, states, states_len);
+
+    if (success && !test_only)
+        success = wlr_backend_commit(server->backend, states, states_len);
+
+    for (size_t i = 0; i < states_len; i++)
+        wlr_output_state_finish(&states[i].base);
+
+    free(states);
+
+    if (test_only)
+        return success;
+
+    if (!success)
+    {
+        //nothing changed
+        struct e_output* output;
+        wl_list_for_each(output, &server->outputs, link)
+            output->config_changed = false;
+
+        return false;
+    }
+
+    //positions aren't part of output state
+    struct wlr_output_configuration_head_v1* head;
+    wl_list_for_each(head, &config->heads, link)
+    {
+        struct e_output* output = head->state.output->data;
+
+        if (output == NULL)
+            continue;
+
+        //disabling migrates containers directly instead of going through hotplug settling, which would arrange all outputs again
+        e_output_update_layout(output, head->state.enabled, head->state.x, head->state.y);
+    }
+
+    //arrange after all outputs are in place, so each one is arranged only once
+    struct e_output* output;
+    wl_list_for_each(output, &server->outputs, link)
+    {
+        bool changed = output->config_changed;
+        output->config_changed = false;
+
+        if (output->scene_output == NULL)
+            continue;
+
+        //active workspace received migrated containers
+        bool migrated = (output->active_workspace != NULL && output->active_workspace->dirty);
+
+        if (!changed && !migrated)
+            continue;
+
+        e_output_arrange(output);
+
+        if (changed && server->seat != NULL)
+            e_cursor_load_scale(server->seat->cursor, output->wlr_output->scale);
+    }
+
+    #if E_XWAYLAND_SUPPORT
+    //layout may have shrunk without any remaining output being arranged, only sent if workarea changed
+    if (server->xwayland != NULL)
+        e_server_update_xwayland_workareas(server);
+    #endif
+
+    return true;
+}
+
+static void server_output_manager_apply(struct wl_listener* listener, void* data)
+{
+    struct e_server* server = wl_container_of(listener, server, output_manager_apply);
+    struct wlr_output_configuration_v1* config = data;
+
+    if (server_apply_output_config(server, config, false))
+    {
+        wlr_output_configuration_v1_send_succeeded(config);
+    }
+    else
+    {
+        e_log_error("server_output_manager_apply: failed to apply output configuration");
+        wlr_output_configuration_v1_send_failed(config);
+    }
+
+    wlr_output_configuration_v1_destroy(config);
+
+    //clients always need the current configuration after applying, even if it failed
+    server_output_manager_schedule_update(server);
+}
+
+static void server_output_manager_test(struct wl_listener* listener, void* data)
+{
+    struct e_server* server = wl_container_of(listener, server, output_manager_test);
+    struct wlr_output_configuration_v1* config = data;
+
+    if (server_apply_output_config(server, config, true))
+        wlr_output_configuration_v1_send_succeeded(config);
+    else
+        wlr_output_configuration_v1_send_failed(config);
+
+    wlr_output_configuration_v1_destroy(config);
 }
 
 bool e_server_init_outputs(struct e_server* server)
@@ -475,25 +1223,54 @@ bool e_server_init_outputs(struct e_server* server)
 
     SIGNAL_CONNECT(server->backend->events.new_output, server->new_output, server_new_output);
 
+    server->output_manager = wlr_output_manager_v1_create(server->display);
+
+    if (server->output_manager != NULL)
+    {
+        SIGNAL_CONNECT(server->output_manager->events.apply, server->output_manager_apply, server_output_manager_apply);
+        SIGNAL_CONNECT(server->output_manager->events.test, server->output_manager_test, server_output_manager_test);
+    }
+    else
+    {
+        e_log_error("e_server_init_outputs: failed to create wlr output manager v1");
+    }
+
+    server->output_manager_update_idle = NULL;
+    SIGNAL_CONNECT(server->output_layout->events.change, server->output_layout_change, server_output_layout_change);
+
+    server->hotplug.settle_timer = wl_event_loop_add_timer(server->event_loop, server_hotplug_settled, server);
+
+    if (server->hotplug.settle_timer == NULL)
+        e_log_error("e_server_init_outputs: failed to create hotplug settle timer, outputs are arranged on every hotplug");
+
     //TODO: move all output specific protocols to here aswell (mostly copy part of output stuff)
 
+    return true;
+}
+
+// Init output capturing protocols (screencopy, export dmabuf, ext image capture).
+void e_server_init_output_capture(struct e_server* server)
+{
+    assert(server);
+
+    if (server == NULL)
+        return;
+
     //allows clients to ask to copy part of the screen content to a client buffer, seems to be fully implemented by wlroots already
     if (wlr_screencopy_manager_v1_create(server->display) == NULL)
-        e_log_error("e_server_init_outputs: failed to create wlr screencopy manager");
+        e_log_error("e_server_init_output_capture: failed to create wlr screencopy manager");
 
     //low overhead screen content capturing
     if (wlr_export_dmabuf_manager_v1_create(server->display) == NULL)
-        e_log_error("e_server_init_outputs: failed to create wlr export dmabuf manager v1");
+        e_log_error("e_server_init_output_capture: failed to create wlr export dmabuf manager v1");
     
     //more screen capturing
     if (wlr_ext_output_image_capture_source_manager_v1_create(server->display, E_EXT_IMAGE_CAPTURE_SOURCE_VERSION) == NULL)
-        e_log_error("e_server_init_outputs: failed to create wlr ext output image capture source manager v1");
+        e_log_error("e_server_init_output_capture: failed to create wlr ext output image capture source manager v1");
 
     //output toplevel capturing
     if (wlr_ext_image_copy_capture_manager_v1_create(server->display, E_EXT_IMAGE_COPY_CAPTURE_VERSION) == NULL)
-        e_log_error("e_server_init_outputs: failed to create wlr ext image copy capture manager v1");
-
-    return true;
+        e_log_error("e_server_init_output_capture: failed to create wlr ext image copy capture manager v1");
 }
 
 void e_server_fini_outputs(struct e_server* server)
@@ -505,6 +1282,12 @@ void e_server_fini_outputs(struct e_server* server)
 
     SIGNAL_DISCONNECT(server->new_output);
 
+    if (server->output_manager != NULL)
+    {
+        SIGNAL_DISCONNECT(server->output_manager_apply);
+        SIGNAL_DISCONNECT(server->output_manager_test);
+    }
+
     //disable & then remove outputs
     struct e_output* output;
     struct e_output* tmp;
@@ -514,5 +1297,20 @@ void e_server_fini_outputs(struct e_server* server)
         e_output_destroy(output);
     }
 
+    //removing outputs from layout may have scheduled an update
+    SIGNAL_DISCONNECT(server->output_layout_change);
+
+    if (server->hotplug.settle_timer != NULL)
+    {
+        wl_event_source_remove(server->hotplug.settle_timer);
+        server->hotplug.settle_timer = NULL;
+    }
+
+    if (server->output_manager_update_idle != NULL)
+    {
+        wl_event_source_remove(server->output_manager_update_idle);
+        server->output_manager_update_idle = NULL;
+    }
+
     wlr_output_layout_destroy(server->output_layout);
 }
\ No newline at end of file
@@ -16,11 +16,14 @@
 #include "desktop/views/view.h"
 #include "desktop/output.h"
 
+#include "input/seat.h"
+
 #include "server.h"
 
 #include "util/wl_macros.h"
 #include "util/list.h"
 #include "util/log.h"
+#include "util/trace.h"
 
 #define CONTAINER_TILE_RESIZE_MIN_PERCENTAGE 0.05f
 
@@ -161,9 +164,23 @@ void e_container_set_workspace(struct e_container* container, struct e_workspace
             }
             break;
         case E_CONTAINER_VIEW:
+            wl_list_remove(&container->view_container->focus_link);
+            wl_list_init(&container->view_container->focus_link);
+
             if (workspace != NULL)
+            {
+                //focused container stays most recent when switching tiling or workspaces, others were focused less recently than what's there
+                if (container->server->seat != NULL && container->server->seat->focus.active_view_container == container->view_container)
+                    wl_list_insert(&workspace->focus_stack, &container->view_container->focus_link);
+                else
+                    wl_list_append(workspace->focus_stack, &container->view_container->focus_link);
+
                 e_view_set_output(container->view_container->view, workspace->output);
 
+                //views on workspaces that aren't displayed don't need to render
+                e_view_set_suspended(container->view_container->view, !workspace->active);
+            }
+
             break;
     }
 }
@@ -178,6 +195,30 @@ void e_container_set_fullscreen(struct e_container* container, bool fullscreen)
         e_view_set_fullscreen(container->view_container->view, fullscreen);
 }
 
+// Set suspended state of views inside container.
+void e_container_set_suspended(struct e_container* container, bool suspended)
+{
+    assert(container);
+
+    switch (container->type)
+    {
+        case E_CONTAINER_TREE:
+            for (int i = 0; i < container->tree_container->children.count; i++)
+            {
+                struct e_container* child = e_list_at(&container->tree_container->children, i);
+                
+                if (child != NULL)
+                    e_container_set_suspended(child, suspended);
+            }
+            break;
+        case E_CONTAINER_VIEW:
+            if (container->view_container->view != NULL)
+                e_view_set_suspended(container->view_container->view, suspended);
+
+            break;
+    }
+}
+
 // Sets the parent of a container.
 // Parent may be NULL.
 // Returns true on success, false on fail.
@@ -256,8 +297,13 @@ static void arrange_view(struct e_view_container* view_container)
         .height = (area->height > 0) ? area->height : 1
     };
 
-    if (view_container->view != NULL)
-        e_view_configure(view_container->view, view_container->view_pending.x, view_container->view_pending.y, view_container->view_pending.width, view_container->view_pending.height);
+    if (view_container->view == NULL)
+        return;
+
+    e_view_configure(view_container->view, view_container->view_pending.x, view_container->view_pending.y, view_container->view_pending.width, view_container->view_pending.height);
+
+    //moved views show up in the next frame, instead of after a commit round-trip
+    e_view_container_apply_pending_position(view_container);
 }
 
 // Arrange container's content within its area.
@@ -265,6 +311,8 @@ void e_container_arrange(struct e_container* container)
 {
     assert(container);
 
+    E_TRACE_BEGIN("e_container_arrange");
+
     switch (container->type)
     {
         case E_CONTAINER_TREE:
@@ -274,6 +322,8 @@ void e_container_arrange(struct e_container* container)
             arrange_view(container->view_container);
             break;
     }
+
+    E_TRACE_END();
 }
 
 void e_container_leave(struct e_container* container)
@@ -295,6 +345,8 @@ void e_container_leave(struct e_container* container)
             e_list_remove_index(&workspace->floating_containers, index);
         
         e_container_set_workspace(container, NULL);
+
+        e_workspace_mark_dirty(workspace);
     }
 
     if (container->parent != NULL)
@@ -676,6 +728,8 @@ static void e_view_container_destroy(struct e_view_container* view_container)
 
     e_container_fini(&view_container->base);
 
+    wl_list_remove(&view_container->focus_link);
+
     free(view_container);
 }
 
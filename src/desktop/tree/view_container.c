@@ -24,6 +24,7 @@
 #include "input/cursor.h"
 
 #include "util/log.h"
+#include "util/watchdog.h"
 #include "util/wl_macros.h"
 
 #include "server.h"
@@ -75,6 +76,8 @@ static void e_view_container_handle_view_map(struct wl_listener* listener, void*
         return;
     }
 
+    e_watchdog_section_begin("view map");
+
     //TODO: xwayland views may want to specify their position through their size hints
 
     e_log_info("map container wants fullscreen: %i", event->fullscreen);
@@ -109,22 +112,31 @@ static void e_view_container_handle_view_map(struct wl_listener* listener, void*
     //TODO: tiled -> parent to previously focused tiled container
 
     e_desktop_set_focus_view_container(view_container->base.server, view_container);
+
+    e_watchdog_section_end();
 }
 
 static void e_view_container_handle_view_unmap(struct wl_listener* listener, void* data)
 {
     struct e_view_container* view_container = wl_container_of(listener, view_container, unmap);
 
+    e_watchdog_section_begin("view unmap");
+
     struct e_workspace* workspace = view_container->base.workspace;
 
     //TODO: if there were multiple seats, focus on this view container should be cleared from all seats
-    if (view_container->base.server->seat->focus.active_view_container == view_container)
-        e_desktop_set_focus_view_container(view_container->base.server, NULL);
+    bool focused = (view_container->base.server->seat->focus.active_view_container == view_container);
 
     e_container_leave(&view_container->base);
 
     if (workspace != NULL)
         e_workspace_rearrange(workspace);
+
+    //focus previously focused view container, without having to find one under the cursor
+    if (focused)
+        e_desktop_set_focus_view_container(view_container->base.server, (workspace != NULL) ? e_workspace_get_recent_view_container(workspace, 0) : NULL);
+
+    e_watchdog_section_end();
 }
 
 static void view_container_update_popup_space(struct e_view_container* view_container)
@@ -195,26 +207,53 @@ static void view_container_apply_geometry(struct e_view_container* view_containe
     view_container->view_pending = view_container->view_current;
 }
 
+// Returns true if view container's view still has to commit a configure for its pending size.
+// Compared to the last configured size instead of the committed one, as views may commit a different size than requested.
+static bool view_container_size_pending(struct e_view_container* view_container)
+{
+    struct e_view* view = view_container->view;
+
+    //nothing configured since view was mapped
+    if (wlr_box_empty(&view->configures.sent))
+    {
+        return (view_container->view_current.width != view_container->view_pending.width
+            || view_container->view_current.height != view_container->view_pending.height);
+    }
+
+    if (view->configures.has_queued || view->configures.sent.width != view_container->view_pending.width || view->configures.sent.height != view_container->view_pending.height)
+        return true;
+
+    bool size_committed = (view_container->view_current.width == view_container->view_pending.width
+        && view_container->view_current.height == view_container->view_pending.height);
+
+    //not acked yet, unless view already committed whatever size it picked for the pending one
+    return (view->configures.in_flight && !size_committed);
+}
+
 static void e_view_container_handle_view_commit(struct wl_listener* listener, void* data)
 {
     struct e_view_container* view_container = wl_container_of(listener, view_container, commit);
 
-    //TODO: view tree node position needs to be updated immediately if only position is changed (not after a commit, like currently), but after a geometry update (not just a commit) if size was also changed
+    //position only changes are applied immediately when configuring, see e_view_container_apply_pending_position
+    //size changes are applied here, together with their position
 
     //TODO: center view if container is tiled?
 
     bool size_changed = (view_container->view_current.width != view_container->view->width
         || view_container->view_current.height != view_container->view->height);
 
-    bool size_pending = (view_container->view_current.width != view_container->view_pending.width
-        || view_container->view_current.height != view_container->view_pending.height);
+    bool size_pending = view_container_size_pending(view_container);
 
     bool position_pending = (view_container->view_current.x != view_container->view_pending.x
         || view_container->view_current.y != view_container->view_pending.y);
 
     //size changed or position pending but no size pending
     if (size_changed || (!size_pending && position_pending))
+    {
+        e_watchdog_section_begin("view commit");
         view_container_apply_geometry(view_container, view_container->view->width, view_container->view->height);
+        e_watchdog_section_end();
+    }
 }
 
 static void e_view_container_handle_view_request_move(struct wl_listener* listener, void* data)
@@ -237,6 +276,8 @@ static void e_view_container_handle_view_request_configure(struct wl_listener* l
     struct e_view_container* view_container = wl_container_of(listener, view_container, request_configure);
     struct e_view_request_configure_event* event = data;
 
+    e_watchdog_section_begin("view request configure");
+
     //only respect configure request if container is floating, otherwise respond with our pending size
 
     if (!e_container_is_tiled(&view_container->base)) //floating
@@ -246,8 +287,17 @@ static void e_view_container_handle_view_request_configure(struct wl_listener* l
     }
     else //tiled
     {
-        e_view_configure(view_container->view, view_container->view_pending.x, view_container->view_pending.y, view_container->view_pending.width, view_container->view_pending.height);
+        struct wlr_box requested = {event->x, event->y, event->width, event->height};
+        struct wlr_box* pending = &view_container->view_pending;
+
+        //view must be told its request was denied, even if its pending geometry was already sent
+        if (!wlr_box_equal(&requested, pending))
+            e_view_configure_force(view_container->view, pending->x, pending->y, pending->width, pending->height);
+        else
+            e_view_configure(view_container->view, pending->x, pending->y, pending->width, pending->height);
     }
+
+    e_watchdog_section_end();
 }
 
 static void e_view_container_handle_view_request_fullscreen(struct wl_listener* listener, void* data)
@@ -326,6 +376,8 @@ struct e_view_container* e_view_container_create(struct e_server* server, struct
 
     view_container->view = view;
 
+    wl_list_init(&view_container->focus_link);
+
     wlr_scene_node_reparent(&view->tree->node, view_container->base.tree);
 
     SIGNAL_CONNECT(view->events.map, view_container->map, e_view_container_handle_view_map);
@@ -346,6 +398,28 @@ struct e_view_container* e_view_container_create(struct e_server* server, struct
     return view_container;
 }
 
+// Moves view container's mapped view to its pending position immediately if its size isn't changing, as moving doesn't need a commit.
+// Returns true if view was moved.
+bool e_view_container_apply_pending_position(struct e_view_container* view_container)
+{
+    assert(view_container);
+
+    if (view_container == NULL || view_container->view == NULL || !view_container->view->mapped)
+        return false;
+
+    bool size_pending = view_container_size_pending(view_container);
+
+    bool position_pending = (view_container->view_current.x != view_container->view_pending.x
+        || view_container->view_current.y != view_container->view_pending.y);
+
+    //size changes wait for the view to commit its new size, so the view doesn't move before it resizes
+    if (size_pending || !position_pending)
+        return false;
+
+    view_container_apply_geometry(view_container, view_container->view_current.width, view_container->view_current.height);
+    return true;
+}
+
 // Finds the view container which has this surface as its view's main surface.
 // Returns NULL on fail.
 struct e_view_container* e_view_container_try_from_surface(struct e_server* server, struct wlr_surface* surface)
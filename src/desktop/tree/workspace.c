@@ -14,14 +14,17 @@
 
 #include "desktop/views/view.h"
 
+#include "desktop/desktop.h"
 #include "desktop/output.h"
 
 #include "util/list.h"
 #include "util/log.h"
+#include "util/trace.h"
 #include "util/wl_macros.h"
 
 #include "protocols/cosmic-workspace-v1.h"
 #include "protocols/ext-workspace-v1.h"
+#include "protocols/workspace-info.h"
 
 #include "server.h"
 
@@ -31,16 +34,29 @@ static void e_workspace_cosmic_request_activate(struct wl_listener* listener, vo
 {
     struct e_workspace* workspace = wl_container_of(listener, workspace, cosmic_request_activate);
 
-    if (workspace->output != NULL && !workspace->active)
-        e_output_display_workspace(workspace->output, workspace);
+    if (workspace->output != NULL && !workspace->active && e_output_display_workspace(workspace->output, workspace))
+        e_desktop_focus_workspace(workspace->output->server, workspace);
 }
 
 static void e_workspace_ext_request_activate(struct wl_listener* listener, void* data)
 {
     struct e_workspace* workspace = wl_container_of(listener, workspace, ext_request_activate);
 
-    if (workspace->output != NULL && !workspace->active)
-        e_output_display_workspace(workspace->output, workspace);
+    if (workspace->output != NULL && !workspace->active && e_output_display_workspace(workspace->output, workspace))
+        e_desktop_focus_workspace(workspace->output->server, workspace);
+}
+
+// Sends changed fields of workspace's info through every workspace protocol.
+// Changes is a bitmask of enum e_workspace_info_change.
+static void workspace_update_handles(struct e_workspace* workspace, uint32_t changes)
+{
+    assert(workspace);
+
+    if (changes == 0)
+        return;
+
+    e_cosmic_workspace_update(workspace->cosmic_handle, changes);
+    e_ext_workspace_update(workspace->ext_handle, changes);
 }
 
 // Create a new workspace for an output.
@@ -66,6 +82,8 @@ struct e_workspace* e_workspace_create(struct e_output* output)
     workspace->output = output;
     workspace->fullscreen_container = NULL;
 
+    wl_list_init(&workspace->focus_stack);
+
     workspace->root_tiling_container = e_tree_container_create(output->server, E_TILING_MODE_HORIZONTAL);
 
     if (workspace->root_tiling_container == NULL)
@@ -76,11 +94,14 @@ struct e_workspace* e_workspace_create(struct e_output* output)
         return NULL;
     }
 
-    workspace->cosmic_handle = e_cosmic_workspace_create(output->workspace_group.cosmic_handle);
+    e_workspace_info_init(&workspace->info);
+
+    workspace->cosmic_handle = e_cosmic_workspace_create(output->workspace_group.cosmic_handle, &workspace->info);
 
     if (workspace->cosmic_handle == NULL)
     {
         e_container_destroy(&workspace->root_tiling_container->base);
+        e_workspace_info_fini(&workspace->info);
         free(workspace);
         
         e_log_error("e_workspace_create: failed to create cosmic workspace handle!");
@@ -89,12 +110,13 @@ struct e_workspace* e_workspace_create(struct e_output* output)
 
     e_cosmic_workspace_set_tiling_state(workspace->cosmic_handle, E_COSMIC_WORKSPACE_TILING_STATE_TILING_ENABLED);
 
-    workspace->ext_handle = e_ext_workspace_create(output->server->ext_workspace_manager, NULL);
+    workspace->ext_handle = e_ext_workspace_create(output->server->ext_workspace_manager, NULL, &workspace->info);
 
     if (workspace->ext_handle == NULL)
     {
         e_container_destroy(&workspace->root_tiling_container->base);
         e_cosmic_workspace_remove(workspace->cosmic_handle);
+        e_workspace_info_fini(&workspace->info);
         free(workspace);
         
         e_log_error("e_workspace_create: failed to create ext workspace handle!");
@@ -129,11 +151,42 @@ void e_workspace_set_name(struct e_workspace* workspace, const char* name)
     if (workspace == NULL || name == NULL)
         return;
 
-    if (workspace->cosmic_handle->name == NULL || strcmp(workspace->cosmic_handle->name, name) != 0)
-        e_cosmic_workspace_set_name(workspace->cosmic_handle, name);
+    workspace_update_handles(workspace, e_workspace_info_set_name(&workspace->info, name));
+}
+
+// Set coordinates of workspace within its output's workspace group.
+void e_workspace_set_coords(struct e_workspace* workspace, uint32_t x)
+{
+    assert(workspace);
+
+    if (workspace == NULL)
+        return;
+
+    struct wl_array coords;
+    wl_array_init(&coords);
+
+    uint32_t* coord = wl_array_add(&coords, sizeof(*coord));
 
-    if (workspace->ext_handle->name == NULL || strcmp(workspace->ext_handle->name, name) != 0)
-        e_ext_workspace_set_name(workspace->ext_handle, name);
+    if (coord != NULL)
+    {
+        *coord = x;
+
+        workspace_update_handles(workspace, e_workspace_info_set_coords(&workspace->info, &coords));
+    }
+
+    wl_array_release(&coords);
+}
+
+// Returns true if workspace has no containers.
+bool e_workspace_is_empty(struct e_workspace* workspace)
+{
+    assert(workspace);
+
+    if (workspace == NULL)
+        return true;
+
+    return workspace->fullscreen_container == NULL && workspace->floating_containers.count == 0
+        && (workspace->root_tiling_container == NULL || workspace->root_tiling_container->children.count == 0);
 }
 
 // Enable/disable workspace trees.
@@ -150,8 +203,34 @@ void e_workspace_set_activated(struct e_workspace* workspace, bool activated)
     workspace->active = activated;
     e_workspace_update_tree_visibility(workspace);
 
-    e_cosmic_workspace_set_active(workspace->cosmic_handle, activated);
-    e_ext_workspace_set_active(workspace->ext_handle, activated);
+    //views of workspaces that aren't displayed don't need to render
+    if (workspace->root_tiling_container != NULL)
+        e_container_set_suspended(&workspace->root_tiling_container->base, !activated);
+
+    for (int i = 0; i < workspace->floating_containers.count; i++)
+    {
+        struct e_container* container = e_list_at(&workspace->floating_containers, i);
+
+        if (container != NULL)
+            e_container_set_suspended(container, !activated);
+    }
+
+    if (workspace->fullscreen_container != NULL)
+        e_container_set_suspended(workspace->fullscreen_container, !activated);
+
+    workspace_update_handles(workspace, e_workspace_info_set_state(&workspace->info, E_WORKSPACE_INFO_STATE_ACTIVE, activated));
+}
+
+// Applies deferred commits of workspace's views that are visible again.
+static void workspace_flush_deferred_commits(struct e_workspace* workspace)
+{
+    struct e_view_container* view_container;
+    struct e_view_container* tmp;
+    wl_list_for_each_safe(view_container, tmp, &workspace->focus_stack, focus_link)
+    {
+        if (view_container->view != NULL)
+            e_view_flush_deferred_commit(view_container->view);
+    }
 }
 
 // Arranges a workspace's children to fit within the given area.
@@ -163,8 +242,14 @@ void e_workspace_arrange(struct e_workspace* workspace, struct wlr_box full_area
         return;
     }
 
+    E_TRACE_BEGIN("e_workspace_arrange");
+
+    //containers may have been moved here from a hidden workspace
+    bool containers_changed = workspace->dirty;
+
     workspace->full_area = full_area;
     workspace->tiled_area = tiled_area;
+    workspace->dirty = false;
 
     if (workspace->fullscreen_container != NULL)
     {
@@ -191,6 +276,15 @@ void e_workspace_arrange(struct e_workspace* workspace, struct wlr_box full_area
     }
 
     e_workspace_update_tree_visibility(workspace);
+
+    if (workspace->active && containers_changed)
+        workspace_flush_deferred_commits(workspace);
+
+    //workspaces are arranged after containers leave them, reclaim it if that was the last one
+    if (!workspace->active && e_workspace_is_empty(workspace))
+        e_output_schedule_workspace_reclaim(workspace->output);
+
+    E_TRACE_END();
 }
 
 // Rearrange workspace within its current area.
@@ -201,6 +295,28 @@ void e_workspace_rearrange(struct e_workspace* workspace)
     e_workspace_arrange(workspace, workspace->full_area, workspace->tiled_area);
 }
 
+// Marks workspace's containers as changed, so it is arranged before it is displayed if nothing else arranges it.
+void e_workspace_mark_dirty(struct e_workspace* workspace)
+{
+    assert(workspace);
+
+    workspace->dirty = true;
+
+    //displayed workspaces are arranged by whoever changed them
+    if (!workspace->active && workspace->output != NULL)
+        e_output_schedule_inactive_workspaces_arrange(workspace->output);
+}
+
+// Enables or disables tree, returns true if it was disabled and is enabled now.
+static bool workspace_set_tree_enabled(struct wlr_scene_tree* tree, bool enabled)
+{
+    bool shown = (enabled && !tree->node.enabled);
+
+    wlr_scene_node_set_enabled(&tree->node, enabled);
+
+    return shown;
+}
+
 // Update visiblity of workspace trees.
 void e_workspace_update_tree_visibility(struct e_workspace* workspace)
 {
@@ -210,13 +326,15 @@ void e_workspace_update_tree_visibility(struct e_workspace* workspace)
         return;
     }
 
+    bool shown = false;
+
     if (workspace->active)
     {
         bool fullscreen = (workspace->fullscreen_container != NULL);
 
-        wlr_scene_node_set_enabled(&workspace->layers.floating->node, !fullscreen);
-        wlr_scene_node_set_enabled(&workspace->layers.tiling->node, !fullscreen);
-        wlr_scene_node_set_enabled(&workspace->layers.fullscreen->node, fullscreen);
+        shown |= workspace_set_tree_enabled(workspace->layers.floating, !fullscreen);
+        shown |= workspace_set_tree_enabled(workspace->layers.tiling, !fullscreen);
+        shown |= workspace_set_tree_enabled(workspace->layers.fullscreen, fullscreen);
     }
     else 
     {
@@ -224,6 +342,10 @@ void e_workspace_update_tree_visibility(struct e_workspace* workspace)
         wlr_scene_node_set_enabled(&workspace->layers.tiling->node, false);
         wlr_scene_node_set_enabled(&workspace->layers.fullscreen->node, false);
     }
+
+    //views that were hidden may be visible now
+    if (shown)
+        workspace_flush_deferred_commits(workspace);
 }
 
 // Adds container as tiled to workspace.
@@ -237,6 +359,8 @@ void e_workspace_add_tiled_container(struct e_workspace* workspace, struct e_con
     e_container_set_parent(container, workspace->root_tiling_container);
     
     e_container_reparented_workspace(container);
+
+    e_workspace_mark_dirty(workspace);
 }
 
 // Adds container as floating to workspace.
@@ -250,6 +374,8 @@ void e_workspace_add_floating_container(struct e_workspace* workspace, struct e_
     e_list_add(&workspace->floating_containers, container);
 
     e_container_reparented_workspace(container);
+
+    e_workspace_mark_dirty(workspace);
 }
 
 // Sets fullscreen container of workspace and fullscreen mode of containers.
@@ -268,6 +394,50 @@ void e_workspace_change_fullscreen_container(struct e_workspace* workspace, stru
         e_container_set_fullscreen(container, true);
 }
 
+// Moves all containers of workspace to target, fullscreen containers stop being fullscreen.
+// Target workspace must be arranged after.
+void e_workspace_move_containers(struct e_workspace* workspace, struct e_workspace* target)
+{
+    assert(workspace && target && workspace != target);
+
+    if (workspace == NULL || target == NULL || workspace == target)
+        return;
+
+    //fullscreen container is one of the tiled or floating containers
+    if (workspace->fullscreen_container != NULL)
+        e_workspace_change_fullscreen_container(workspace, NULL);
+
+    //copy containers, leaving removes them from the lists
+    struct e_list* tiled_containers = &workspace->root_tiling_container->children;
+    struct e_list containers = { 0 }; //struct e_container*
+    e_list_init(&containers, tiled_containers->count + workspace->floating_containers.count + 1);
+
+    for (int i = 0; i < tiled_containers->count; i++)
+        e_list_add(&containers, e_list_at(tiled_containers, i));
+
+    int tiled_count = containers.count;
+
+    for (int i = 0; i < workspace->floating_containers.count; i++)
+        e_list_add(&containers, e_list_at(&workspace->floating_containers, i));
+
+    for (int i = 0; i < containers.count; i++)
+    {
+        struct e_container* container = e_list_at(&containers, i);
+
+        e_container_leave(container);
+
+        if (i < tiled_count)
+            e_workspace_add_tiled_container(target, container);
+        else
+            e_workspace_add_floating_container(target, container);
+    }
+
+    e_list_fini(&containers);
+
+    e_workspace_mark_dirty(workspace);
+    e_workspace_mark_dirty(target);
+}
+
 // Returns NULL on fail.
 static struct e_workspace* e_workspace_try_from_node(struct wlr_scene_node* node)
 {
@@ -286,6 +456,27 @@ static struct e_workspace* e_workspace_try_from_node(struct wlr_scene_node* node
         return NULL;
 }
 
+// Returns view container of workspace that was focused before the given amount of other ones, 0 being the most recent.
+// Returns NULL if workspace doesn't have that many view containers.
+struct e_view_container* e_workspace_get_recent_view_container(struct e_workspace* workspace, int index)
+{
+    assert(workspace && index >= 0);
+
+    if (workspace == NULL)
+        return NULL;
+
+    struct e_view_container* view_container;
+    wl_list_for_each(view_container, &workspace->focus_stack, focus_link)
+    {
+        if (index == 0)
+            return view_container;
+
+        index--;
+    }
+
+    return NULL;
+}
+
 // Get workspace from node ancestors.
 // Returns NULL on fail.
 struct e_workspace* e_workspace_try_from_node_ancestors(struct wlr_scene_node* node)
@@ -350,6 +541,8 @@ void e_workspace_destroy(struct e_workspace* workspace)
     SIGNAL_DISCONNECT(workspace->ext_request_activate);
     e_ext_workspace_remove(workspace->ext_handle);
 
+    e_workspace_info_fini(&workspace->info);
+
     e_container_destroy(&workspace->root_tiling_container->base);
     workspace->root_tiling_container = NULL;
     
@@ -13,6 +13,7 @@
 #include <wlr/util/edges.h>
 #include <wlr/util/box.h>
 
+#include "desktop/client.h"
 #include "desktop/desktop.h"
 #include "desktop/output.h"
 #include "desktop/tree/node.h"
@@ -22,6 +23,7 @@
 #include "input/cursor.h"
 
 #include "util/log.h"
+#include "util/trace.h"
 #include "util/wl_macros.h"
 
 /* Toplevel view popups */
@@ -74,6 +76,11 @@ static void xdg_popup_handle_destroy(struct wl_listener* listener, void* data)
 {
     struct e_xdg_popup* popup = wl_container_of(listener, popup, destroy);
 
+    struct e_client* client = e_client_from_surface(popup->xdg_popup->base->surface);
+
+    if (client != NULL)
+        client->popups--;
+
     SIGNAL_DISCONNECT(popup->reposition);
     SIGNAL_DISCONNECT(popup->new_popup);
     SIGNAL_DISCONNECT(popup->commit);
@@ -106,6 +113,11 @@ static struct e_xdg_popup* xdg_popup_create(struct wlr_xdg_popup* xdg_popup, str
     SIGNAL_CONNECT(xdg_popup->base->surface->events.commit, popup->commit, xdg_popup_handle_commit);
     SIGNAL_CONNECT(xdg_popup->events.destroy, popup->destroy, xdg_popup_handle_destroy);
 
+    struct e_client* client = e_client_from_surface(xdg_popup->base->surface);
+
+    if (client != NULL)
+        client->popups++;
+
     return popup;
 }
 
@@ -192,6 +204,8 @@ static void e_toplevel_view_unmap(struct wl_listener* listener, void* data)
 static void e_toplevel_view_commit(struct wl_listener* listener, void* data)
 {
     struct e_toplevel_view* toplevel_view = wl_container_of(listener, toplevel_view, commit);
+
+    E_TRACE_BEGIN("e_toplevel_view_commit");
         
     if (toplevel_view->xdg_toplevel->base->initial_commit)
     {
@@ -201,12 +215,17 @@ static void e_toplevel_view_commit(struct wl_listener* listener, void* data)
 
         //0x0 size to let views configure their size themselves, instead of forcing min or max size
         wlr_xdg_toplevel_set_size(toplevel_view->xdg_toplevel, 0, 0);        
+        E_TRACE_END();
         return;
     }
 
     toplevel_view_update_geometry(toplevel_view);
 
-    wl_signal_emit_mutable(&toplevel_view->base.events.commit, NULL);
+    e_view_ack_configure(&toplevel_view->base, toplevel_view->xdg_toplevel->base->current.configure_serial);
+
+    e_view_commit(&toplevel_view->base);
+
+    E_TRACE_END();
 }
 
 //new wlr_xdg_popup by toplevel view
@@ -353,7 +372,19 @@ static void e_view_toplevel_set_fullscreen(struct e_view* view, bool fullscreen)
     wlr_xdg_toplevel_set_fullscreen(toplevel_view->xdg_toplevel, fullscreen);
 }
 
-static void e_view_toplevel_configure(struct e_view* view, int lx, int ly, int width, int height)
+// Set the suspended state of the view.
+static void e_view_toplevel_set_suspended(struct e_view* view, bool suspended)
+{
+    assert(view);
+
+    struct e_toplevel_view* toplevel_view = view->data;
+
+    //suspended state was added in xdg wm base v6
+    if (wl_resource_get_version(toplevel_view->xdg_toplevel->resource) >= XDG_TOPLEVEL_STATE_SUSPENDED_SINCE_VERSION)
+        wlr_xdg_toplevel_set_suspended(toplevel_view->xdg_toplevel, suspended);
+}
+
+static uint32_t e_view_toplevel_configure(struct e_view* view, int lx, int ly, int width, int height)
 {
     assert(view && view->content_tree && view->data);
 
@@ -363,7 +394,7 @@ static void e_view_toplevel_configure(struct e_view* view, int lx, int ly, int w
     e_log_info("toplevel configure");
     #endif
     
-    wlr_xdg_toplevel_set_size(toplevel_view->xdg_toplevel, width, height);
+    return wlr_xdg_toplevel_set_size(toplevel_view->xdg_toplevel, width, height);
 }
 
 static bool e_view_toplevel_wants_floating(struct e_view* view)
@@ -393,6 +424,7 @@ static const struct e_view_impl view_toplevel_implementation = {
     
     .set_activated = e_view_toplevel_set_activated,
     .set_fullscreen = e_view_toplevel_set_fullscreen,
+    .set_suspended = e_view_toplevel_set_suspended,
 
     .configure = e_view_toplevel_configure,
     .create_content_tree = e_view_toplevel_create_content_tree,
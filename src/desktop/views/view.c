@@ -3,6 +3,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <assert.h>
+#include <sys/types.h>
 
 #include <wayland-server-core.h>
 #include <wayland-util.h>
@@ -13,6 +14,7 @@
 #include <wlr/util/edges.h>
 #include <wlr/util/box.h>
 
+#include "desktop/client.h"
 #include "desktop/desktop.h"
 #include "desktop/foreign_toplevel.h"
 #include "desktop/output.h"
@@ -24,9 +26,29 @@
 #include "input/seat.h"
 
 #include "util/log.h"
+#include "util/time.h"
+#include "util/trace.h"
 
 #include "server.h"
 
+// Configures that take longer than this to be committed are logged, to find slow clients.
+#define SLOW_CONFIGURE_MS 200.0
+
+// Interval in which commit rates of views are reported.
+#define COMMIT_REPORT_INTERVAL_MS 10000.0
+// Views committing this many times per second while hidden are reported, even in non-verbose builds.
+#define HIDDEN_COMMIT_RATE_REPORT_HZ 5.0
+
+// Forget configures sent to view, as they no longer apply to its new surface state.
+static void view_reset_configures(struct e_view* view)
+{
+    view->configures.sent = (struct wlr_box){0, 0, 0, 0};
+    view->configures.serial = 0;
+    view->configures.in_flight = false;
+    view->configures.queued = (struct wlr_box){0, 0, 0, 0};
+    view->configures.has_queued = false;
+}
+
 //this function should only be called by the implementations of each view type. 
 //I mean it would be a bit weird to even call this function somewhere else.
 void e_view_init(struct e_view* view, enum e_view_type type, void* data, const struct e_view_impl* implementation, struct e_server* server)
@@ -61,6 +83,20 @@ void e_view_init(struct e_view* view, enum e_view_type type, void* data, const s
 
     view->output = NULL;
 
+    view_reset_configures(view);
+    view->configures.sent_count = 0;
+    view->configures.suppressed_count = 0;
+    view->configures.acked_count = 0;
+    view->configures.latency_last_ms = 0.0;
+    view->configures.latency_max_ms = 0.0;
+    view->configures.latency_total_ms = 0.0;
+
+    view->commit_stats.commits = 0;
+    view->commit_stats.hidden_commits = 0;
+
+    view->commit_deferred = false;
+    wl_list_init(&view->deferred_link);
+
     // signals
 
     wl_signal_init(&view->events.map);
@@ -133,7 +169,7 @@ void e_view_set_popup_space(struct e_view* view, struct wlr_box popup_space)
     view->popup_space = popup_space;
 }
 
-void e_view_configure(struct e_view* view, int lx, int ly, int width, int height)
+static void view_send_configure(struct e_view* view, struct wlr_box geometry)
 {
     assert(view);
 
@@ -141,10 +177,286 @@ void e_view_configure(struct e_view* view, int lx, int ly, int width, int height
     e_log_info("view configure");
     #endif
 
-    if (view->implementation->configure != NULL)
-        view->implementation->configure(view, lx, ly, width, height);
-    else
+    view->configures.serial = view->implementation->configure(view, geometry.x, geometry.y, geometry.width, geometry.height);
+    view->configures.sent = geometry;
+    view->configures.sent_time = e_time_now();
+    view->configures.in_flight = true;
+    view->configures.sent_count++;
+}
+
+// Returns true if configuring view with geometry wouldn't tell it anything the last sent configure didn't.
+static bool view_configure_is_sent(struct e_view* view, struct wlr_box geometry)
+{
+    assert(view);
+
+    //configures of views that ack them only carry size, their position is applied by the compositor
+    if (view->configures.serial != 0)
+        return (geometry.width == view->configures.sent.width && geometry.height == view->configures.sent.height);
+
+    return wlr_box_equal(&geometry, &view->configures.sent);
+}
+
+static void view_configure(struct e_view* view, struct wlr_box geometry, bool force)
+{
+    assert(view);
+
+    if (view->implementation->configure == NULL)
+    {
         e_log_error("e_view_configure: configure is not implemented!");
+        return;
+    }
+
+    E_TRACE_BEGIN("e_view_configure");
+
+    //view already has or is getting this geometry, drop anything newer that was waiting
+    if (!force && view_configure_is_sent(view, geometry))
+    {
+        view->configures.has_queued = false;
+        view->configures.suppressed_count++;
+        E_TRACE_END();
+        return;
+    }
+
+    //only keep the latest configure while view hasn't acked the previous one, so slow clients don't fall further behind
+    if (view->configures.in_flight && view->configures.serial != 0)
+    {
+        if (view->configures.has_queued)
+            view->configures.suppressed_count++;
+
+        view->configures.queued = geometry;
+        view->configures.has_queued = true;
+        E_TRACE_END();
+        return;
+    }
+
+    view_send_configure(view, geometry);
+
+    E_TRACE_END();
+}
+
+// Configures a view within given layout position and size.
+// Configures identical to the last sent one are suppressed, and while one is in flight only the latest is kept.
+void e_view_configure(struct e_view* view, int lx, int ly, int width, int height)
+{
+    view_configure(view, (struct wlr_box){lx, ly, width, height}, false);
+}
+
+// Configures a view within given layout position and size, even if it already has or is getting it.
+// Used to answer requests that were denied, so the view knows its geometry didn't change.
+void e_view_configure_force(struct e_view* view, int lx, int ly, int width, int height)
+{
+    view_configure(view, (struct wlr_box){lx, ly, width, height}, true);
+}
+
+// Returns true if view isn't visible, because it isn't mapped, its workspace isn't displayed or a fullscreen container covers it.
+bool e_view_is_hidden(struct e_view* view)
+{
+    assert(view);
+
+    if (!view->mapped)
+        return true;
+
+    //false if view tree or any of its ancestors is disabled
+    int lx, ly;
+    return !wlr_scene_node_coords(&view->tree->node, &lx, &ly);
+}
+
+// View committed new surface state, emits commit signal.
+// Commits of hidden views are only applied once they're shown again.
+void e_view_commit(struct e_view* view)
+{
+    assert(view);
+
+    view->commit_stats.commits++;
+
+    struct e_client* client = e_client_from_surface(view->surface);
+    struct timespec start = e_time_now();
+
+    //mapped views are in a workspace's trees, nothing to place while they aren't visible
+    if (view->mapped && e_view_is_hidden(view))
+    {
+        view->commit_stats.hidden_commits++;
+
+        if (!view->commit_deferred)
+        {
+            view->commit_deferred = true;
+            wl_list_insert(&view->server->hidden_views.deferred_commits, &view->deferred_link);
+        }
+
+        e_client_add_handler_time(client, &start);
+        return;
+    }
+
+    wl_signal_emit_mutable(&view->events.commit, NULL);
+
+    e_client_add_handler_time(client, &start);
+}
+
+// Applies deferred commit of view if it is visible again.
+void e_view_flush_deferred_commit(struct e_view* view)
+{
+    assert(view);
+
+    if (!view->commit_deferred || e_view_is_hidden(view))
+        return;
+
+    view->commit_deferred = false;
+    wl_list_remove(&view->deferred_link);
+    wl_list_init(&view->deferred_link);
+
+    wl_signal_emit_mutable(&view->events.commit, NULL);
+}
+
+// Applies deferred commits of views that are visible again.
+void e_view_flush_deferred_commits(struct e_server* server)
+{
+    assert(server);
+
+    struct e_view* view;
+    struct e_view* tmp;
+    wl_list_for_each_safe(view, tmp, &server->hidden_views.deferred_commits, deferred_link)
+        e_view_flush_deferred_commit(view);
+}
+
+static void send_frame_done_iterator(struct wlr_surface* surface, int sx, int sy, void* data)
+{
+    struct timespec* now = data;
+
+    wlr_surface_send_frame_done(surface, now);
+}
+
+// Logs commit rates of views since last report, then resets them.
+static void report_commit_rates(struct e_server* server, double elapsed_ms)
+{
+    double elapsed_s = elapsed_ms / 1000.0;
+
+    struct e_view_container* view_container;
+    wl_list_for_each(view_container, &server->view_containers, link)
+    {
+        struct e_view* view = view_container->view;
+        double hidden_rate_hz = view->commit_stats.hidden_commits / elapsed_s;
+
+        #if E_VERBOSE
+        bool report = (view->commit_stats.commits > 0);
+        #else
+        bool report = (hidden_rate_hz >= HIDDEN_COMMIT_RATE_REPORT_HZ);
+        #endif
+
+        if (report && view->surface != NULL)
+        {
+            pid_t pid = 0;
+            wl_client_get_credentials(wl_resource_get_client(view->surface->resource), &pid, NULL, NULL);
+
+            e_log_info("view %s (pid %i): %.1f commits/s, %.1f commits/s while hidden", (view->app_id != NULL) ? view->app_id : "(null)", (int)pid,
+                view->commit_stats.commits / elapsed_s, hidden_rate_hz);
+        }
+
+        view->commit_stats.commits = 0;
+        view->commit_stats.hidden_commits = 0;
+    }
+}
+
+// Sends frame callbacks to hidden views at configured rate, so they don't stall completely but don't render at full rate either.
+static int hidden_views_frame(void* data)
+{
+    struct e_server* server = data;
+
+    int32_t rate_hz = server->config->hidden_view_frame_rate_hz;
+    struct timespec now = e_time_now();
+
+    if (rate_hz > 0)
+    {
+        struct e_view_container* view_container;
+        wl_list_for_each(view_container, &server->view_containers, link)
+        {
+            struct e_view* view = view_container->view;
+
+            //visible views get frame callbacks from their outputs
+            if (view->mapped && view->surface != NULL && e_view_is_hidden(view))
+                wlr_surface_for_each_surface(view->surface, send_frame_done_iterator, &now);
+        }
+    }
+
+    double elapsed_ms = e_time_diff_ms(&server->hidden_views.report_time, &now);
+
+    if (elapsed_ms >= COMMIT_REPORT_INTERVAL_MS)
+    {
+        report_commit_rates(server, elapsed_ms);
+        server->hidden_views.report_time = now;
+    }
+
+    //keep firing to report commit rates, even if no frame callbacks are sent
+    wl_event_source_timer_update(server->hidden_views.frame_timer, (rate_hz > 0) ? 1000 / rate_hz : 1000);
+
+    return 0;
+}
+
+// Init handling of views that aren't visible.
+bool e_server_init_views(struct e_server* server)
+{
+    assert(server);
+
+    wl_list_init(&server->hidden_views.deferred_commits);
+    server->hidden_views.report_time = e_time_now();
+
+    server->hidden_views.frame_timer = wl_event_loop_add_timer(server->event_loop, hidden_views_frame, server);
+
+    if (server->hidden_views.frame_timer == NULL)
+    {
+        e_log_error("e_server_init_views: failed to create hidden view frame timer");
+        return false;
+    }
+
+    wl_event_source_timer_update(server->hidden_views.frame_timer, 1000);
+
+    return true;
+}
+
+void e_server_fini_views(struct e_server* server)
+{
+    assert(server);
+
+    if (server->hidden_views.frame_timer != NULL)
+    {
+        wl_event_source_remove(server->hidden_views.frame_timer);
+        server->hidden_views.frame_timer = NULL;
+    }
+}
+
+// View committed, acking configures up to given serial.
+// Serial is 0 if view type doesn't ack configures, any commit then acks the last sent configure.
+void e_view_ack_configure(struct e_view* view, uint32_t serial)
+{
+    assert(view);
+
+    if (!view->configures.in_flight)
+        return;
+
+    //clients may skip acking older configures, but serials only increase
+    if (view->configures.serial != 0 && (int32_t)(serial - view->configures.serial) < 0)
+        return;
+
+    struct timespec now = e_time_now();
+    double latency_ms = e_time_diff_ms(&view->configures.sent_time, &now);
+
+    view->configures.in_flight = false;
+    view->configures.acked_count++;
+    view->configures.latency_last_ms = latency_ms;
+    view->configures.latency_total_ms += latency_ms;
+
+    if (latency_ms > view->configures.latency_max_ms)
+    {
+        view->configures.latency_max_ms = latency_ms;
+
+        if (latency_ms > SLOW_CONFIGURE_MS)
+            e_log_info("view %s: took %.2f ms to commit configure", (view->app_id != NULL) ? view->app_id : "(null)", latency_ms);
+    }
+
+    if (view->configures.has_queued)
+    {
+        view->configures.has_queued = false;
+        view_send_configure(view, view->configures.queued);
+    }
 }
 
 void e_view_set_tiled(struct e_view* view, bool tiled)
@@ -180,6 +492,21 @@ void e_view_set_fullscreen(struct e_view* view, bool fullscreen)
         e_log_error("e_view_set_fullscreen: set fullscreen not implemented!");
 }
 
+// Set the suspended state of the view, suspended views aren't visible and don't need to render.
+void e_view_set_suspended(struct e_view* view, bool suspended)
+{
+    assert(view);
+
+    if (view->suspended == suspended)
+        return;
+
+    view->suspended = suspended;
+
+    //not every view type can be suspended
+    if (view->implementation->set_suspended != NULL)
+        view->implementation->set_suspended(view, suspended);
+}
+
 void e_view_base_set_activated(struct e_view* view, bool activated)
 {
     assert(view);
@@ -259,6 +586,11 @@ void e_view_map(struct e_view* view, bool fullscreen, struct e_output* fullscree
 
     view->mapped = true;
 
+    struct e_client* client = e_client_from_surface(view->surface);
+
+    if (client != NULL)
+        client->views++;
+
     struct e_view_map_event view_event = {
         .fullscreen = fullscreen,
         .fullscreen_output = fullscreen_output,
@@ -279,6 +611,18 @@ void e_view_unmap(struct e_view* view)
 
     view->mapped = false;
 
+    struct e_client* client = e_client_from_surface(view->surface);
+
+    if (client != NULL)
+        client->views--;
+
+    //remapped views start over with their own size
+    view_reset_configures(view);
+
+    view->commit_deferred = false;
+    wl_list_remove(&view->deferred_link);
+    wl_list_init(&view->deferred_link);
+
     if (view->content_tree != NULL)
     {
         wlr_scene_node_destroy(&view->content_tree->node);
@@ -370,5 +714,11 @@ void e_view_fini(struct e_view* view)
     if (view->mapped)
         e_view_unmap(view);
 
+    #if E_VERBOSE
+    double average_latency_ms = (view->configures.acked_count > 0) ? view->configures.latency_total_ms / view->configures.acked_count : 0.0;
+    e_log_info("view %s: %llu configures sent, %llu suppressed, committed in %.2f ms on average, %.2f ms max", (view->app_id != NULL) ? view->app_id : "(null)",
+        (unsigned long long)view->configures.sent_count, (unsigned long long)view->configures.suppressed_count, average_latency_ms, view->configures.latency_max_ms);
+    #endif
+
     wlr_scene_node_destroy(&view->tree->node);
 }
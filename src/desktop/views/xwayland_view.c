@@ -23,6 +23,7 @@
 #include "input/cursor.h"
 
 #include "util/log.h"
+#include "util/trace.h"
 #include "util/wl_macros.h"
 
 //TODO: use xwayland_view_impl_* instead of e_view_xwayland_* for better consistency across other files
@@ -83,9 +84,16 @@ static void e_xwayland_view_commit(struct wl_listener* listener, void* data)
 {
     struct e_xwayland_view* xwayland_view = wl_container_of(listener, xwayland_view, commit);
 
+    E_TRACE_BEGIN("e_xwayland_view_commit");
+
     xwayland_view_update_geometry(xwayland_view);
 
-    wl_signal_emit_mutable(&xwayland_view->base.events.commit, NULL);
+    //x11 has no configure acks
+    e_view_ack_configure(&xwayland_view->base, 0);
+
+    e_view_commit(&xwayland_view->base);
+
+    E_TRACE_END();
 }
 
 // Surface is ready to be displayed.
@@ -304,17 +312,16 @@ static void e_xwayland_view_destroy(struct wl_listener* listener, void* data)
     free(xwayland_view);
 }
 
-static void e_view_xwayland_configure(struct e_view* view, int lx, int ly, int width, int height)
+static uint32_t e_view_xwayland_configure(struct e_view* view, int lx, int ly, int width, int height)
 {
     assert(view);
 
     struct e_xwayland_view* xwayland_view = view->data;
 
+    //also sends a synthetic configure notify, so x11 clients know their new position without committing
+    //views are moved immediately if only their position changed, so offscreen surfaces that never commit still move
     wlr_xwayland_surface_configure(xwayland_view->xwayland_surface, lx, ly, (uint16_t)width, (uint16_t)height);
-
-    //TODO: according to labwc, if the xwayland surface is offscreen it may not send a commit event
-    // and thus not move the view as wait we for a commit that never happens. In these cases we should move it immediately.
-    // Views aren't usually offscreen though, so this shouldn't be that big of a deal.
+    return 0;
 }
 
 static bool e_view_xwayland_wants_floating(struct e_view* view)
@@ -67,6 +67,8 @@ static void xwayland_ready(struct wl_listener* listener, void* data)
 
     e_log_info("xwayland is ready!");
 
+    //new connection, always send workarea
+    server->xwayland_workarea_sent = false;
     e_server_update_xwayland_workareas(server);
 }
 
@@ -78,6 +80,7 @@ bool e_server_init_xwayland(struct e_server* server, struct e_seat* seat, bool l
         return false;
 
     server->xwayland = wlr_xwayland_create(server->display, server->compositor, lazy);
+    server->xwayland_workarea_sent = false;
 
     if (server->xwayland == NULL)
     {
@@ -109,7 +112,8 @@ void e_server_fini_xwayland(struct e_server* server)
     wlr_xwayland_destroy(server->xwayland);
 }
 
-// Update useable geometry not covered by panels, docks, etc. for xwayland
+// Update useable geometry not covered by panels, docks, etc. for xwayland.
+// Workarea is only sent if it changed.
 void e_server_update_xwayland_workareas(struct e_server* server)
 {
     assert(server && server->xwayland);
@@ -126,10 +130,12 @@ void e_server_update_xwayland_workareas(struct e_server* server)
     if (wl_list_empty(&server->outputs))
         return;
 
-    //TODO: set separate workareas for each output
-    //TODO: use useable area for workarea only
+    //_NET_WORKAREA holds one workarea per virtual desktop, not per output, so it is the whole layout without the exclusive zones along its outer edges
+    struct wlr_box layout_box = (struct wlr_box){0, 0, 0, 0};
+    wlr_output_layout_get_box(server->output_layout, NULL, &layout_box);
 
-    struct wlr_output_layout* layout = server->output_layout;
+    if (wlr_box_empty(&layout_box))
+        return;
 
     int left = 0;
     int right = 0;
@@ -139,22 +145,38 @@ void e_server_update_xwayland_workareas(struct e_server* server)
     struct e_output* output = NULL;
     wl_list_for_each(output, &server->outputs, link)
     {
-        struct wlr_box output_box;
-        wlr_output_layout_get_box(layout, output->wlr_output, &output_box);
+        if (output->scene_output == NULL || wlr_box_empty(&output->usable_area))
+            continue;
+
+        struct wlr_box output_box = (struct wlr_box){0, 0, 0, 0};
+        wlr_output_layout_get_box(server->output_layout, output->wlr_output, &output_box);
 
-        if (output_box.x < left)
-            left = output_box.x;
+        struct wlr_box* usable_area = &output->usable_area;
 
-        if (output_box.x + output_box.width > right)
-            right = output_box.x + output_box.width;
+        if (output_box.x == layout_box.x && usable_area->x - output_box.x > left)
+            left = usable_area->x - output_box.x;
 
-        if (output_box.y < top)
-            top = output_box.y;
+        if (output_box.x + output_box.width == layout_box.x + layout_box.width && (output_box.x + output_box.width) - (usable_area->x + usable_area->width) > right)
+            right = (output_box.x + output_box.width) - (usable_area->x + usable_area->width);
 
-        if (output_box.y + output_box.height > bottom)
-            bottom = output_box.y + output_box.height;
+        if (output_box.y == layout_box.y && usable_area->y - output_box.y > top)
+            top = usable_area->y - output_box.y;
+
+        if (output_box.y + output_box.height == layout_box.y + layout_box.height && (output_box.y + output_box.height) - (usable_area->y + usable_area->height) > bottom)
+            bottom = (output_box.y + output_box.height) - (usable_area->y + usable_area->height);
     }
 
-    struct wlr_box workarea = {left, top, right - left, bottom - top};
+    struct wlr_box workarea = {layout_box.x + left, layout_box.y + top, layout_box.width - left - right, layout_box.height - top - bottom};
+
+    if (wlr_box_empty(&workarea))
+        workarea = layout_box;
+
+    //unchanged, x11 clients already place themselves correctly
+    if (server->xwayland_workarea_sent && wlr_box_equal(&workarea, &server->xwayland_workarea))
+        return;
+
+    server->xwayland_workarea = workarea;
+    server->xwayland_workarea_sent = true;
+
     wlr_xwayland_set_workareas(xwayland, &workarea, 1);
 }
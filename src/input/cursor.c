@@ -3,6 +3,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
 #include <wayland-server-core.h>
@@ -29,6 +30,8 @@
 
 #include "util/list.h"
 #include "util/log.h"
+#include "util/trace.h"
+#include "util/watchdog.h"
 #include "util/wl_macros.h"
 
 #include "server.h"
@@ -91,14 +94,22 @@ static void start_grab_move_focused_view_container(struct e_cursor* cursor)
         e_cursor_start_container_move(cursor, &focused_view_container->base);
 }
 
+static void cursor_apply_focus_hover(struct e_cursor* cursor);
+
 //mouse button presses
 static void e_cursor_button(struct wl_listener* listener, void* data)
 {
     struct e_cursor* cursor = wl_container_of(listener, cursor, button);
     struct wlr_pointer_button_event* event = data;
 
+    e_watchdog_section_begin("cursor button");
+
     bool handled = false;
 
+    //clicks act on the hovered surface, so it must have focus first
+    if (event->state == WL_POINTER_BUTTON_STATE_PRESSED)
+        cursor_apply_focus_hover(cursor);
+
     struct wlr_keyboard* keyboard = wlr_seat_get_keyboard(cursor->seat->wlr_seat);
 
     //is ALT modifier is pressed on keyboard? (for both cases within here, cursor mode should be in default mode)
@@ -128,6 +139,8 @@ static void e_cursor_button(struct wl_listener* listener, void* data)
     //send to clients if button hasn't been handled
     if (!handled)
         wlr_seat_pointer_notify_button(cursor->seat->wlr_seat, event->time_msec, event->button, event->state);
+
+    e_watchdog_section_end();
 }
 
 // TODO: move to tree container?
@@ -201,7 +214,7 @@ static void e_cursor_handle_mode_move(struct e_cursor* cursor)
         return;
     }
 
-    wlr_cursor_set_xcursor(cursor->wlr_cursor, cursor->xcursor_manager, "all-scroll");
+    e_cursor_set_xcursor(cursor, "all-scroll");
 
     if (e_container_is_tiled(cursor->grab_container))
     {
@@ -420,13 +433,17 @@ static void e_cursor_handle_mode_resize(struct e_cursor* cursor)
 
 static void e_cursor_handle_motion(struct e_cursor* cursor, uint32_t time_msec)
 {
+    E_TRACE_BEGIN("e_cursor_handle_motion");
+
     switch (cursor->mode)
     {
         case E_CURSOR_MODE_MOVE:
             e_cursor_handle_mode_move(cursor);
+            E_TRACE_END();
             return;
         case E_CURSOR_MODE_RESIZE:
             e_cursor_handle_mode_resize(cursor);
+            E_TRACE_END();
             return;
         default:
             break;
@@ -442,6 +459,8 @@ static void e_cursor_handle_motion(struct e_cursor* cursor, uint32_t time_msec)
 
     if (hover_surface != NULL)
         wlr_seat_pointer_notify_motion(seat->wlr_seat, time_msec, sx, sy);
+
+    E_TRACE_END();
 }
 
 static void e_cursor_motion(struct wl_listener* listener, void* data)
@@ -449,6 +468,8 @@ static void e_cursor_motion(struct wl_listener* listener, void* data)
     struct e_cursor* cursor = wl_container_of(listener, cursor, motion);
     struct wlr_pointer_motion_event* event = data;
 
+    e_watchdog_section_begin("cursor motion");
+
     struct e_server* server = cursor->seat->server;
 
     wlr_relative_pointer_manager_v1_send_relative_motion(
@@ -463,6 +484,8 @@ static void e_cursor_motion(struct wl_listener* listener, void* data)
     wlr_cursor_move(cursor->wlr_cursor, &event->pointer->base, event->delta_x, event->delta_y);
 
     e_cursor_handle_motion(cursor, event->time_msec);
+
+    e_watchdog_section_end();
 }
 
 static void e_cursor_motion_absolute(struct wl_listener* listener, void* data)
@@ -470,6 +493,8 @@ static void e_cursor_motion_absolute(struct wl_listener* listener, void* data)
     struct e_cursor* cursor = wl_container_of(listener, cursor, motion_absolute);
     struct wlr_pointer_motion_absolute_event* event = data;
 
+    e_watchdog_section_begin("cursor motion absolute");
+
     double lx, ly;
     wlr_cursor_absolute_to_layout_coords(cursor->wlr_cursor, &event->pointer->base, event->x, event->y, &lx, &ly);
     
@@ -490,6 +515,8 @@ static void e_cursor_motion_absolute(struct wl_listener* listener, void* data)
     wlr_cursor_warp_absolute(cursor->wlr_cursor, &event->pointer->base, event->x, event->y);
     
     e_cursor_handle_motion(cursor, event->time_msec);
+
+    e_watchdog_section_end();
 }
 
 //scroll event
@@ -544,9 +571,10 @@ struct e_cursor* e_cursor_create(struct e_seat* seat, struct wlr_output_layout*
     //boundaries and movement semantics of cursor
     wlr_cursor_attach_output_layout(cursor->wlr_cursor, output_layout);
 
-    //load xcursor theme
+    //load xcursor theme, images for other scales are loaded once outputs with them are added
     cursor->xcursor_manager = wlr_xcursor_manager_create(get_xcursor_theme_name(), 24);
-    wlr_cursor_set_xcursor(cursor->wlr_cursor, cursor->xcursor_manager, "default");
+    e_cursor_load_scale(cursor, 1.0f);
+    e_cursor_set_xcursor(cursor, "default");
 
     // events
 
@@ -565,12 +593,49 @@ void e_cursor_set_mode(struct e_cursor* cursor, enum e_cursor_mode mode)
     cursor->mode = mode;
 }
 
+// Displays xcursor shape by name, does nothing if it is already displayed.
+void e_cursor_set_xcursor(struct e_cursor* cursor, const char* name)
+{
+    assert(cursor && name);
+
+    if (strcmp(cursor->xcursor_name, name) == 0)
+        return;
+
+    wlr_cursor_set_xcursor(cursor->wlr_cursor, cursor->xcursor_manager, name);
+
+    //too long names are simply never cached
+    if (snprintf(cursor->xcursor_name, E_CURSOR_XCURSOR_NAME_MAX, "%s", name) >= E_CURSOR_XCURSOR_NAME_MAX)
+        cursor->xcursor_name[0] = '\0';
+}
+
+// Displays surface of a client as cursor image.
+// Surface is allowed to be NULL, which hides the cursor.
+void e_cursor_set_surface(struct e_cursor* cursor, struct wlr_surface* surface, int32_t hotspot_x, int32_t hotspot_y)
+{
+    assert(cursor);
+
+    wlr_cursor_set_surface(cursor->wlr_cursor, surface, hotspot_x, hotspot_y);
+
+    //xcursor shape is no longer displayed
+    cursor->xcursor_name[0] = '\0';
+}
+
+// Loads xcursor theme for scale ahead of time, so cursor images are ready once cursor enters an output with that scale.
+void e_cursor_load_scale(struct e_cursor* cursor, float scale)
+{
+    assert(cursor);
+
+    //does nothing if already loaded
+    if (!wlr_xcursor_manager_load(cursor->xcursor_manager, scale))
+        e_log_error("e_cursor_load_scale: failed to load xcursor theme at scale %.2f", scale);
+}
+
 void e_cursor_reset_mode(struct e_cursor* cursor)
 {
     e_log_info("reset mode");
 
     cursor->mode = E_CURSOR_MODE_DEFAULT;
-    wlr_cursor_set_xcursor(cursor->wlr_cursor, cursor->xcursor_manager, "default");
+    e_cursor_set_xcursor(cursor, "default");
 
     //let go of container
     if (cursor->grab_container != NULL)
@@ -640,7 +705,7 @@ static void e_cursor_set_xcursor_resize(struct e_cursor* cursor, enum wlr_edges
     //no edges can be resized or more than 2 directions
     if (i < 1 || i > 2)
     {
-        wlr_cursor_set_xcursor(cursor->wlr_cursor, cursor->xcursor_manager, "not-allowed");
+        e_cursor_set_xcursor(cursor, "not-allowed");
         return;
     }
 
@@ -655,7 +720,7 @@ static void e_cursor_set_xcursor_resize(struct e_cursor* cursor, enum wlr_edges
         return;
 
     //Resize cursor name is copied.
-    wlr_cursor_set_xcursor(cursor->wlr_cursor, cursor->xcursor_manager, resize_cursor_name);
+    e_cursor_set_xcursor(cursor, resize_cursor_name);
 }
 
 // Starts grabbing a container under the resize mode, resizing along specified edges.
@@ -732,7 +797,130 @@ static void set_focus_from_surface(struct e_seat* seat, struct wlr_surface* surf
     }
 }
 
+static void cursor_cancel_focus_hover(struct e_cursor* cursor)
+{
+    assert(cursor);
+
+    cursor->hover_focus.pending = false;
+    cursor->hover_focus.dwelling = false;
+    cursor->hover_focus.surface = NULL;
+
+    //disarm
+    if (cursor->hover_focus.dwell_timer != NULL)
+        wl_event_source_timer_update(cursor->hover_focus.dwell_timer, 0);
+}
+
+// Focuses hovered surface now, if a focus change is waiting for a frame or for the cursor to rest.
+static void cursor_apply_focus_hover(struct e_cursor* cursor)
+{
+    assert(cursor);
+
+    if (!cursor->hover_focus.pending && !cursor->hover_focus.dwelling)
+        return;
+
+    cursor_cancel_focus_hover(cursor);
+
+    //only update focus in default mode
+    if (cursor->mode != E_CURSOR_MODE_DEFAULT)
+        return;
+
+    struct e_seat* seat = cursor->seat;
+
+    //hovered surface may have changed or been destroyed since, so look it up again
+    double sx, sy;
+    struct wlr_scene_surface* hover_surface = e_desktop_scene_surface_at(&seat->server->scene->tree.node, cursor->wlr_cursor->x, cursor->wlr_cursor->y, &sx, &sy);
+
+    if (hover_surface != NULL)
+        set_focus_from_surface(seat, hover_surface->surface);
+}
+
+// Applies keyboard focus change to hovered surface, if one is waiting for this frame.
+void e_cursor_flush_focus_hover(struct e_cursor* cursor)
+{
+    assert(cursor);
+
+    if (cursor->hover_focus.pending)
+        cursor_apply_focus_hover(cursor);
+}
+
+// Lets focus change be applied on the next frame of the output under cursor.
+static void cursor_focus_hover_on_frame(struct e_cursor* cursor)
+{
+    assert(cursor);
+
+    cursor->hover_focus.pending = true;
+
+    struct wlr_output* wlr_output = wlr_output_layout_output_at(cursor->seat->server->output_layout, cursor->wlr_cursor->x, cursor->wlr_cursor->y);
+
+    //cursor may move without damage, so make sure there is a next frame
+    if (wlr_output != NULL)
+        wlr_output_schedule_frame(wlr_output);
+    else
+        cursor_apply_focus_hover(cursor);
+}
+
+static int cursor_handle_focus_hover_dwell(void* data)
+{
+    struct e_cursor* cursor = data;
+
+    cursor->hover_focus.dwelling = false;
+
+    cursor_focus_hover_on_frame(cursor);
+
+    return 0;
+}
+
+// Schedules keyboard focus change to hovered surface, so crossing several surfaces within a frame or without resting only focuses the last one.
+static void cursor_schedule_focus_hover(struct e_cursor* cursor, struct wlr_surface* surface)
+{
+    assert(cursor && surface);
+
+    surface = wlr_surface_get_root_surface(surface);
+
+    struct e_seat* seat = cursor->seat;
+
+    //moved back onto focused surface before focus changed, nothing to do anymore
+    if (e_seat_has_focus(seat, surface))
+    {
+        cursor_cancel_focus_hover(cursor);
+        return;
+    }
+
+    int32_t delay_ms = seat->server->config->hover_focus_delay_ms;
+
+    if (delay_ms > 0)
+    {
+        //same surface, keep waiting for dwell that already started or frame after it
+        if (cursor->hover_focus.surface == surface && (cursor->hover_focus.dwelling || cursor->hover_focus.pending))
+            return;
+
+        if (cursor->hover_focus.dwell_timer == NULL)
+            cursor->hover_focus.dwell_timer = wl_event_loop_add_timer(seat->server->event_loop, cursor_handle_focus_hover_dwell, cursor);
+
+        //can't wait, focus now instead of never
+        if (cursor->hover_focus.dwell_timer == NULL)
+        {
+            e_log_error("cursor_schedule_focus_hover: failed to create dwell timer");
+            set_focus_from_surface(seat, surface);
+            return;
+        }
+
+        cursor_cancel_focus_hover(cursor);
+
+        cursor->hover_focus.dwelling = true;
+        cursor->hover_focus.surface = surface;
+        wl_event_source_timer_update(cursor->hover_focus.dwell_timer, delay_ms);
+        return;
+    }
+
+    cursor->hover_focus.surface = surface;
+
+    if (!cursor->hover_focus.pending)
+        cursor_focus_hover_on_frame(cursor);
+}
+
 // Sets seat focus to whatever surface is under cursor.
+// Keyboard focus changes are coalesced, so only the last surface hovered gets focus.
 // If nothing is under cursor, doesn't change seat focus.
 void e_cursor_set_focus_hover(struct e_cursor* cursor)
 {
@@ -752,7 +940,7 @@ void e_cursor_set_focus_hover(struct e_cursor* cursor)
         wlr_seat_pointer_notify_enter(seat->wlr_seat, hover_surface->surface, sx, sy); //is only sent once
 
         //sloppy focus
-        set_focus_from_surface(seat, hover_surface->surface);
+        cursor_schedule_focus_hover(cursor, hover_surface->surface);
     }
     else 
     {
@@ -761,7 +949,7 @@ void e_cursor_set_focus_hover(struct e_cursor* cursor)
 
     //display default cursor when not hovering any VIEWS (not just any surface)
     if (view == NULL)
-        wlr_cursor_set_xcursor(cursor->wlr_cursor, cursor->xcursor_manager, "default");
+        e_cursor_set_xcursor(cursor, "default");
 }
 
 void e_cursor_destroy(struct e_cursor* cursor)
@@ -772,6 +960,11 @@ void e_cursor_destroy(struct e_cursor* cursor)
     if (cursor->grab_container != NULL)
         e_cursor_reset_mode(cursor);
 
+    cursor_cancel_focus_hover(cursor);
+
+    if (cursor->hover_focus.dwell_timer != NULL)
+        wl_event_source_remove(cursor->hover_focus.dwell_timer);
+
     SIGNAL_DISCONNECT(cursor->frame);
     SIGNAL_DISCONNECT(cursor->button);
     SIGNAL_DISCONNECT(cursor->motion);
@@ -18,6 +18,8 @@
 
 #include "util/list.h"
 #include "util/log.h"
+#include "util/thread_pool.h"
+#include "util/watchdog.h"
 #include "util/wl_macros.h"
 
 #include "config.h"
@@ -48,10 +50,12 @@ static void e_keyboard_key(struct wl_listener* listener, void* data)
     struct e_keyboard* keyboard = wl_container_of(listener, keyboard, key);
     struct wlr_keyboard_key_event* event = data;
 
+    e_watchdog_section_begin("keyboard key");
+
     bool handled = false;
 
-    //handle keybinds if any
-    if (event->state == WL_KEYBOARD_KEY_STATE_PRESSED)
+    //handle keybinds if any, keymap may still be compiling
+    if (event->state == WL_KEYBOARD_KEY_STATE_PRESSED && keyboard->wlr_keyboard->xkb_state != NULL)
     {
         //translate libinput keycode to xkbcommon keycode
         uint32_t xkb_keycode = event->keycode + 8;
@@ -75,6 +79,8 @@ static void e_keyboard_key(struct wl_listener* listener, void* data)
         wlr_seat_set_keyboard(keyboard->seat->wlr_seat, keyboard->wlr_keyboard);
         wlr_seat_keyboard_notify_key(keyboard->seat->wlr_seat, event->time_msec, event->keycode, event->state);
     }
+
+    e_watchdog_section_end();
 }
 
 static void e_keyboard_modifiers(struct wl_listener* listener, void* data)
@@ -92,6 +98,74 @@ static void e_keyboard_handle_destroy(struct wl_listener* listener, void* data)
     e_keyboard_destroy(keyboard);
 }
 
+struct keyboard_keymap_job
+{
+    // NULL if keyboard was destroyed before keymap was compiled
+    struct e_keyboard* keyboard;
+
+    // NULL on fail
+    struct xkb_keymap* keymap;
+};
+
+// Compiles default keymap, runs on a worker thread.
+static void keyboard_keymap_job_work(void* data)
+{
+    struct keyboard_keymap_job* job = data;
+
+    //contexts aren't thread safe, so each job uses its own
+    struct xkb_context* xkb_context = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+
+    if (xkb_context == NULL)
+        return;
+
+    job->keymap = xkb_keymap_new_from_names(xkb_context, NULL, XKB_KEYMAP_COMPILE_NO_FLAGS);
+
+    xkb_context_unref(xkb_context);
+}
+
+static void keyboard_keymap_job_done(void* data)
+{
+    struct keyboard_keymap_job* job = data;
+
+    if (job->keyboard != NULL)
+    {
+        job->keyboard->keymap_job = NULL;
+
+        if (job->keymap != NULL)
+            wlr_keyboard_set_keymap(job->keyboard->wlr_keyboard, job->keymap);
+        else
+            e_log_error("keyboard_keymap_job_done: failed to compile keymap");
+    }
+
+    if (job->keymap != NULL)
+        xkb_keymap_unref(job->keymap);
+
+    free(job);
+}
+
+// Compiles keymap of keyboard on server's thread pool, or immediately if it has none.
+static void keyboard_load_keymap(struct e_keyboard* keyboard)
+{
+    struct keyboard_keymap_job* job = calloc(1, sizeof(*job));
+
+    if (job == NULL)
+    {
+        e_log_error("keyboard_load_keymap: failed to allocate job");
+        return;
+    }
+
+    job->keyboard = keyboard;
+    keyboard->keymap_job = job;
+
+    struct e_thread_pool* thread_pool = keyboard->seat->server->thread_pool;
+
+    if (thread_pool == NULL || !e_thread_pool_submit(thread_pool, keyboard_keymap_job_work, keyboard_keymap_job_done, job))
+    {
+        keyboard_keymap_job_work(job);
+        keyboard_keymap_job_done(job);
+    }
+}
+
 struct e_keyboard* e_keyboard_create(struct wlr_keyboard* wlr_keyboard, struct e_seat* seat)
 {
     assert(wlr_keyboard && seat);
@@ -107,13 +181,8 @@ struct e_keyboard* e_keyboard_create(struct wlr_keyboard* wlr_keyboard, struct e
     keyboard->seat = seat;
     keyboard->wlr_keyboard = wlr_keyboard;
 
-    struct xkb_context* xkb_context = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
-    struct xkb_keymap* keymap = xkb_keymap_new_from_names(xkb_context, NULL, XKB_KEYMAP_COMPILE_NO_FLAGS);
-
-    wlr_keyboard_set_keymap(wlr_keyboard, keymap);
-
-    xkb_keymap_unref(keymap);
-    xkb_context_unref(xkb_context);
+    //keymap compilation reads many files, keyboard has no keymap until it is done
+    keyboard_load_keymap(keyboard);
 
     struct e_config* config = seat->server->config;
     wlr_keyboard_set_repeat_info(wlr_keyboard, config->keyboard.repeat_rate_hz, config->keyboard.repeat_delay_ms);
@@ -140,6 +209,10 @@ void e_keyboard_destroy(struct e_keyboard* keyboard)
 
     wl_list_remove(&keyboard->link);
 
+    //job is freed once it completes
+    if (keyboard->keymap_job != NULL)
+        keyboard->keymap_job->keyboard = NULL;
+
     SIGNAL_DISCONNECT(keyboard->key);
     SIGNAL_DISCONNECT(keyboard->modifiers);
     SIGNAL_DISCONNECT(keyboard->destroy);
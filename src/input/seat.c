@@ -25,6 +25,7 @@
 #include "desktop/output.h"
 #include "desktop/layer_shell.h"
 #include "desktop/tree/container.h"
+#include "desktop/tree/workspace.h"
 
 #include "util/log.h"
 #include "util/wl_macros.h"
@@ -44,7 +45,7 @@ static void e_seat_request_set_cursor_shape(struct wl_listener* listener, void*
 
     //any client can request, only allow focused client to actually set the surface of the cursor
     if (event->seat_client == seat->wlr_seat->pointer_state.focused_client)
-        wlr_cursor_set_xcursor(seat->cursor->wlr_cursor, seat->cursor->xcursor_manager, wlr_cursor_shape_v1_name(event->shape));
+        e_cursor_set_xcursor(seat->cursor, wlr_cursor_shape_v1_name(event->shape));
 }
 
 static void e_seat_request_set_cursor(struct wl_listener* listener, void* data)
@@ -54,7 +55,7 @@ static void e_seat_request_set_cursor(struct wl_listener* listener, void* data)
 
     //any client can request, only allow focused client to actually set the surface of the cursor
     if (event->seat_client == seat->wlr_seat->pointer_state.focused_client)
-        wlr_cursor_set_surface(seat->cursor->wlr_cursor, event->surface, event->hotspot_x, event->hotspot_y);
+        e_cursor_set_surface(seat->cursor, event->surface, event->hotspot_x, event->hotspot_y);
 }
 
 static void e_seat_request_set_selection(struct wl_listener* listener, void* data)
@@ -79,13 +80,38 @@ static void e_seat_request_set_primary_selection(struct wl_listener* listener, v
 
 /* drag & drop */
 
+// Moves drag & drop icon to cursor if cursor moved since, so icon is repositioned at most once per frame.
+void e_seat_update_drag_icon(struct e_seat* seat)
+{
+    assert(seat);
+
+    if (!seat->current_dnd.icon_moved)
+        return;
+
+    seat->current_dnd.icon_moved = false;
+
+    if (seat->current_dnd.icon != NULL)
+        wlr_scene_node_set_position(&seat->current_dnd.icon->node, seat->cursor->wlr_cursor->x, seat->cursor->wlr_cursor->y);
+}
+
 // Motion during drag & drop action.
 static void e_seat_drag_motion(struct wl_listener* listener, void* data)
 {
     struct e_seat* seat = wl_container_of(listener, seat, current_dnd.motion);
 
-    if (seat->current_dnd.icon != NULL)
-        wlr_scene_node_set_position(&seat->current_dnd.icon->node, seat->cursor->wlr_cursor->x, seat->cursor->wlr_cursor->y);
+    if (seat->current_dnd.icon == NULL || seat->current_dnd.icon_moved)
+        return;
+
+    //repositioning damages icon, so only do it once for the next frame instead of for every motion event
+    seat->current_dnd.icon_moved = true;
+
+    //cursor itself may move without damage, so make sure there is a next frame
+    struct wlr_output* wlr_output = wlr_output_layout_output_at(seat->server->output_layout, seat->cursor->wlr_cursor->x, seat->cursor->wlr_cursor->y);
+
+    if (wlr_output != NULL)
+        wlr_output_schedule_frame(wlr_output);
+    else
+        e_seat_update_drag_icon(seat);
 }
 
 // Drag & drop action ended.
@@ -93,6 +119,10 @@ static void e_seat_drag_destroy(struct wl_listener* listener, void* data)
 {
     struct e_seat* seat = wl_container_of(listener, seat, current_dnd.destroy);
 
+    //icon node is destroyed along with drag's icon
+    seat->current_dnd.icon = NULL;
+    seat->current_dnd.icon_moved = false;
+
     SIGNAL_DISCONNECT(seat->current_dnd.motion);
     SIGNAL_DISCONNECT(seat->current_dnd.destroy);
 }
@@ -168,6 +198,7 @@ static void e_seat_init_dnd(struct e_seat* seat)
     }
 
     seat->current_dnd.icon = NULL;
+    seat->current_dnd.icon_moved = false;
     seat->drag_icon_tree = wlr_scene_tree_create(&seat->server->scene->tree);
 
     SIGNAL_CONNECT(seat->wlr_seat->events.request_start_drag, seat->request_start_drag, e_seat_request_start_drag);
@@ -371,6 +402,13 @@ static void seat_set_active_view_container(struct e_seat* seat, struct e_view_co
         e_view_set_activated(view_container->view, true);
         e_container_raise_to_top(&view_container->base);
 
+        //most recently focused
+        if (view_container->base.workspace != NULL)
+        {
+            wl_list_remove(&view_container->focus_link);
+            wl_list_insert(&view_container->base.workspace->focus_stack, &view_container->focus_link);
+        }
+
         struct e_output* output = (view_container->base.workspace != NULL) ? view_container->base.workspace->output : NULL;
 
         if (output != NULL && output->active_workspace != view_container->base.workspace)
@@ -398,8 +436,15 @@ bool e_seat_set_focus_layer_surface(struct e_seat* seat, struct e_layer_surface*
     //unfocus current layer surface and attempt to set focus to active view container
     if (layer_surface == NULL)
     {
+        struct e_view_container* view_container = seat->focus.active_view_container;
+        struct e_output* output = seat->focus.focused_layer_surface->output;
+
+        //no active view container, fall back to most recent one of workspace below layer surface
+        if (view_container == NULL && output != NULL && output->active_workspace != NULL)
+            view_container = e_workspace_get_recent_view_container(output->active_workspace, 0);
+
         seat->focus.focused_layer_surface = NULL;
-        e_seat_set_focus_view_container(seat, seat->focus.active_view_container);
+        e_seat_set_focus_view_container(seat, view_container);
         return true;
     }
 
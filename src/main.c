@@ -10,10 +10,14 @@
 
 #include "session.h"
 #include "config.h"
+#include "config_watch.h"
 #include "server.h"
 
 #include "input/keybind.h"
 #include "util/log.h"
+#include "util/wl_macros.h"
+
+#define CONFIG_FILE_NAME "config"
 
 static bool bind_keybind(struct e_list* keybinds, xkb_keysym_t keysym, enum wlr_keyboard_modifier mods, const char* command)
 {
@@ -25,17 +29,21 @@ static bool bind_keybind(struct e_list* keybinds, xkb_keysym_t keysym, enum wlr_
     return e_list_add(keybinds, keybind);
 }
 
-// Called when event loop is ready.
-static void event_loop_handle_ready(void* data)
+// Called when server is ready, after first frame & deferred globals.
+static void server_handle_ready(struct wl_listener* listener, void* data)
 {
-    e_log_info("event loop is ready!");
+    struct e_server* server = data;
+
+    e_log_info("server is ready!");
 
     e_log_info("running autostart.sh script");
 
     if (!e_session_autostart_run())
-        e_log_error("event_loop_ready: failed to run autostart.sh");
+        e_log_error("server_handle_ready: failed to run autostart.sh");
 
-    /* idle events are automatically removed when they're done */
+    e_server_startup_phase(server, "autostart");
+
+    wl_list_remove(&listener->link);
 }
 
 // Entry point program
@@ -50,20 +58,31 @@ int main()
     struct e_config config = {0};
     e_config_init(&config);
 
-    // test keybinds
-    
-    //check out: xkbcommon.org
-    //Important function: xkb_keysym_from_name (const char *name, enum xkb_keysym_flags flags)
-    
-    bind_keybind(&config.keyboard.keybinds, XKB_KEY_F1, WLR_MODIFIER_LOGO, "exec rofi -modi drun,run -show drun");
-    bind_keybind(&config.keyboard.keybinds, XKB_KEY_F2, WLR_MODIFIER_LOGO, "exec $TERM");
-    bind_keybind(&config.keyboard.keybinds, XKB_KEY_F3, WLR_MODIFIER_LOGO, "exit");
-    bind_keybind(&config.keyboard.keybinds, XKB_KEY_F4, WLR_MODIFIER_LOGO, "kill");
-    bind_keybind(&config.keyboard.keybinds, XKB_KEY_F5, WLR_MODIFIER_LOGO, "toggle_fullscreen");
-    bind_keybind(&config.keyboard.keybinds, XKB_KEY_F6, WLR_MODIFIER_LOGO, "toggle_tiled");
-    bind_keybind(&config.keyboard.keybinds, XKB_KEY_F7, WLR_MODIFIER_LOGO, "switch_tiling_mode");
-    bind_keybind(&config.keyboard.keybinds, XKB_KEY_F8, WLR_MODIFIER_LOGO, "next_workspace");
-    bind_keybind(&config.keyboard.keybinds, XKB_KEY_F9, WLR_MODIFIER_LOGO, "move_to_next_workspace");
+    char config_path[E_CONFIG_PATHS_MAX_SIZE];
+    size_t config_path_length = e_session_get_relative_config_path(config_path, E_CONFIG_PATHS_MAX_SIZE - 1, CONFIG_FILE_NAME);
+    bool config_path_valid = (config_path_length < E_CONFIG_PATHS_MAX_SIZE);
+
+    if (!config_path_valid)
+        e_log_error("main: config file path name is longer than %i characters. (%s, %i)", E_CONFIG_PATHS_MAX_SIZE - 1, config_path, config_path_length);
+
+    //fall back to default keybinds without a valid config file
+    if (!config_path_valid || !e_config_parse_config_file(config_path, &config))
+    {
+        e_log_info("using default keybinds");
+
+        //check out: xkbcommon.org
+        //Important function: xkb_keysym_from_name (const char *name, enum xkb_keysym_flags flags)
+        
+        bind_keybind(&config.keyboard.keybinds, XKB_KEY_F1, WLR_MODIFIER_LOGO, "exec rofi -modi drun,run -show drun");
+        bind_keybind(&config.keyboard.keybinds, XKB_KEY_F2, WLR_MODIFIER_LOGO, "exec $TERM");
+        bind_keybind(&config.keyboard.keybinds, XKB_KEY_F3, WLR_MODIFIER_LOGO, "exit");
+        bind_keybind(&config.keyboard.keybinds, XKB_KEY_F4, WLR_MODIFIER_LOGO, "kill");
+        bind_keybind(&config.keyboard.keybinds, XKB_KEY_F5, WLR_MODIFIER_LOGO, "toggle_fullscreen");
+        bind_keybind(&config.keyboard.keybinds, XKB_KEY_F6, WLR_MODIFIER_LOGO, "toggle_tiled");
+        bind_keybind(&config.keyboard.keybinds, XKB_KEY_F7, WLR_MODIFIER_LOGO, "switch_tiling_mode");
+        bind_keybind(&config.keyboard.keybinds, XKB_KEY_F8, WLR_MODIFIER_LOGO, "next_workspace");
+        bind_keybind(&config.keyboard.keybinds, XKB_KEY_F9, WLR_MODIFIER_LOGO, "move_to_next_workspace");
+    }
     
     struct e_server server = {0};
 
@@ -73,18 +92,29 @@ int main()
         return 1;
     }
 
+    //run autostart script when server is ready, so autostarted clients see every global
+    struct wl_listener ready = {0};
+    SIGNAL_CONNECT(server.events.ready, ready, server_handle_ready);
+
     e_server_start(&server);
 
-    //run autostart script when event loop is ready, removed automatically when dispatched
-    //so when event loop is ready
-    if (server.event_loop == NULL || wl_event_loop_add_idle(server.event_loop, event_loop_handle_ready, NULL) == NULL)
-        e_log_error("main: failed to add autostart.sh event");
+    //reload config when config file changes
+    struct e_config_watch* config_watch = NULL;
+
+    if (config_path_valid)
+        config_watch = e_config_watch_create(&server, config_path);
+
+    if (config_watch == NULL)
+        e_log_error("main: failed to watch config file, config won't reload");
 
     e_server_run(&server);
 
     // display runs
 
     // destroy everything
+
+    if (config_watch != NULL)
+        e_config_watch_destroy(config_watch);
     
     e_server_fini(&server);
 
@@ -1,5 +1,6 @@
 #include "protocols/cosmic-workspace-v1.h"
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -13,9 +14,12 @@
 
 #include <wlr/types/wlr_output.h>
 
+#include "util/watchdog.h"
 #include "util/wl_macros.h"
 
 #include "protocols/transactions.h"
+#include "protocols/workspace-client.h"
+#include "protocols/workspace-info.h"
 
 #include "cosmic-workspace-unstable-v1-protocol.h"
 
@@ -76,6 +80,14 @@ static void wl_array_append_uint32_t(struct wl_array* array, uint32_t num)
 
 static void e_cosmic_workspace_manager_schedule_done_event(struct e_cosmic_workspace_manager* manager);
 
+/* workspace client */
+
+static const struct e_workspace_client_impl workspace_client_impl = {
+    .send_manager_done = zcosmic_workspace_manager_v1_send_done,
+    .send_group_output_enter = zcosmic_workspace_group_handle_v1_send_output_enter,
+    .send_group_output_leave = zcosmic_workspace_group_handle_v1_send_output_leave
+};
+
 /* group output */
 
 static void group_output_destroy(struct group_output* group_output)
@@ -85,16 +97,11 @@ static void group_output_destroy(struct group_output* group_output)
     if (group_output == NULL)
         return;
 
-    //send output enter using every group resource to every output resource
-    struct wl_resource* group_resource;
-    wl_list_for_each(group_resource, &group_output->group->resources, link)
+    //send output leave to group resources of each output resource's client
+    struct wl_resource* output_resource;
+    wl_list_for_each(output_resource, &group_output->output->resources, link)
     {
-        struct wl_resource* output_resource;
-        wl_list_for_each(output_resource, &group_output->output->resources, link)
-        {
-            if (wl_resource_get_client(group_resource) == wl_resource_get_client(output_resource))
-                zcosmic_workspace_group_handle_v1_send_output_leave(group_resource, output_resource);
-        }    
+        e_workspace_client_send_group_output_event(&workspace_client_impl, group_output->group, output_resource, false);
     }
 
     SIGNAL_DISCONNECT(group_output->group_destroy);
@@ -121,34 +128,9 @@ static void group_output_output_bind(struct wl_listener* listener, void* data)
 
     struct wlr_output_event_bind* event = data;
 
-    //client that bound to output
-    struct wl_client* client = wl_resource_get_client(event->resource);
-
-    bool event_sent = false;
-
-    //TODO: Can there be multiple resources for the same client? I don't think there can be, but just in case it can happen, I won't break the loop.
-
-    //send output enter event to group resources for this client.
-    struct wl_resource* group_resource;
-    wl_list_for_each(group_resource, &group_output->group->resources, link)
-    {
-        if (wl_resource_get_client(group_resource) == client)
-        {
-            zcosmic_workspace_group_handle_v1_send_output_enter(group_resource, event->resource);
-            event_sent = true;
-        }
-    }
-
-    if (!event_sent)
-        return;
-
-    //if we sent an event, send done event to manager resource for this client
-    struct wl_resource* manager_resource;
-    wl_list_for_each(manager_resource, &group_output->group->manager->resources, link)
-    {
-        if (wl_resource_get_client(manager_resource) == client)
-            zcosmic_workspace_manager_v1_send_done(manager_resource);
-    }
+    //send output enter event to group resources for this client, if we sent any, send done event to this client
+    if (e_workspace_client_send_group_output_event(&workspace_client_impl, group_output->group, event->resource, true))
+        e_workspace_client_send_done(wl_resource_get_client(event->resource), &workspace_client_impl);
 }
 
 static void group_output_output_destroy(struct wl_listener* listener, void* data)
@@ -185,6 +167,7 @@ struct workspace_rename_event
     struct wl_listener destroy;
 };
 
+// Event is stored inside its operation, only its name needs freeing.
 void workspace_rename_event_destroy(struct wl_listener* listener, void* data)
 {
     struct workspace_rename_event* event = wl_container_of(listener, event, destroy);
@@ -192,17 +175,6 @@ void workspace_rename_event_destroy(struct wl_listener* listener, void* data)
     SIGNAL_DISCONNECT(event->destroy);
 
     free(event->name);
-
-    free(event);
-}
-
-void e_cosmic_workspace_request_tiling_state_event_destroy(struct wl_listener* listener, void* data)
-{
-    struct e_cosmic_workspace_request_tiling_state_event* event = wl_container_of(listener, event, destroy);
-
-    SIGNAL_DISCONNECT(event->destroy);
-
-    free(event);
 }
 
 static void e_cosmic_workspace_request_activate(struct wl_client* client, struct wl_resource* resource)
@@ -226,71 +198,59 @@ static void e_cosmic_workspace_request_remove(struct wl_client* client, struct w
 static void e_cosmic_workspace_request_rename(struct wl_client* client, struct wl_resource* resource, const char* name)
 {
     struct e_cosmic_workspace* workspace = wl_resource_get_user_data(resource);
-    struct workspace_rename_event* event = calloc(1, sizeof(*event));
 
-    if (event == NULL)
-    {
-        wl_client_post_no_memory(client);
-        return;
-    }
-
-    event->name = e_strdup(name);
+    char* copy = e_strdup(name);
 
-    if (event->name == NULL)
+    if (copy == NULL)
     {
-        free(event);
         wl_client_post_no_memory(client);
         return;
     }
 
-    struct e_trans_op* operation = e_trans_session_add_op(&workspace->group->manager->trans_session, workspace, MANAGER_WORKSPACE_RENAME, event);
+    struct e_trans_op* operation = e_trans_session_add_op_inline(&workspace->group->manager->trans_session, workspace, MANAGER_WORKSPACE_RENAME, sizeof(struct workspace_rename_event));
 
     if (operation == NULL)
     {
-        free(event->name);
-        free(event);
+        free(copy);
         wl_client_post_no_memory(client);
         return;
     }
 
+    struct workspace_rename_event* event = operation->data;
+    event->name = copy;
+
     SIGNAL_CONNECT(operation->destroy, event->destroy, workspace_rename_event_destroy);
 }
 
 static void e_cosmic_workspace_request_set_tiling_state(struct wl_client* client, struct wl_resource* resource, uint32_t tiling_state)
 {
     struct e_cosmic_workspace* workspace = wl_resource_get_user_data(resource);
-    struct e_cosmic_workspace_request_tiling_state_event* event = calloc(1, sizeof(*event));
 
-    if (event == NULL)
-    {
-        wl_client_post_no_memory(client);
-        return;
-    }
+    enum e_cosmic_workspace_tiling_state requested_tiling_state;
 
     switch (tiling_state)
     {
         case ZCOSMIC_WORKSPACE_HANDLE_V1_TILING_STATE_FLOATING_ONLY:
-            event->tiling_state = E_COSMIC_WORKSPACE_TILING_STATE_FLOATING_ONLY;
+            requested_tiling_state = E_COSMIC_WORKSPACE_TILING_STATE_FLOATING_ONLY;
             break;
         case ZCOSMIC_WORKSPACE_HANDLE_V1_TILING_STATE_TILING_ENABLED:
-            event->tiling_state = E_COSMIC_WORKSPACE_TILING_STATE_TILING_ENABLED;
+            requested_tiling_state = E_COSMIC_WORKSPACE_TILING_STATE_TILING_ENABLED;
             break;
         default:
             //ignore request
-            free(event);
             return;
     }
 
-    struct e_trans_op* operation = e_trans_session_add_op(&workspace->group->manager->trans_session, workspace, MANAGER_WORKSPACE_SET_TILING_STATE, event);
+    struct e_trans_op* operation = e_trans_session_add_op_inline(&workspace->group->manager->trans_session, workspace, MANAGER_WORKSPACE_SET_TILING_STATE, sizeof(struct e_cosmic_workspace_request_tiling_state_event));
 
     if (operation == NULL)
     {
-        free(event);
         wl_client_post_no_memory(client);
         return;
     }
 
-    SIGNAL_CONNECT(operation->destroy, event->destroy, e_cosmic_workspace_request_tiling_state_event_destroy);
+    struct e_cosmic_workspace_request_tiling_state_event* event = operation->data;
+    event->tiling_state = requested_tiling_state;
 }
 
 // Client does not want workspace object anymore.
@@ -315,13 +275,13 @@ static void workspace_state_to_wl_array(uint32_t workspace_state, struct wl_arra
     if (array == NULL)
         return;
 
-    if (workspace_state & E_COSMIC_WORKSPACE_STATE_ACTIVE)
+    if (workspace_state & E_WORKSPACE_INFO_STATE_ACTIVE)
         wl_array_append_uint32_t(array, (uint32_t)ZCOSMIC_WORKSPACE_HANDLE_V1_STATE_ACTIVE);
 
-    if (workspace_state & E_COSMIC_WORKSPACE_STATE_URGENT)
+    if (workspace_state & E_WORKSPACE_INFO_STATE_URGENT)
         wl_array_append_uint32_t(array, (uint32_t)ZCOSMIC_WORKSPACE_HANDLE_V1_STATE_URGENT);
 
-    if (workspace_state & E_COSMIC_WORKSPACE_STATE_HIDDEN)
+    if (workspace_state & E_WORKSPACE_INFO_STATE_HIDDEN)
         wl_array_append_uint32_t(array, (uint32_t)ZCOSMIC_WORKSPACE_HANDLE_V1_STATE_HIDDEN);
 }
 
@@ -401,11 +361,11 @@ static void workspace_resource_send_init(struct e_cosmic_workspace* workspace, s
 
     workspace_resource_send_capabilities(workspace, resource);
 
-    if (workspace->coords.size != 0)
-        zcosmic_workspace_handle_v1_send_coordinates(resource, &workspace->coords);
+    if (workspace->info->coords.size != 0)
+        zcosmic_workspace_handle_v1_send_coordinates(resource, &workspace->info->coords);
 
-    if (workspace->name != NULL)
-        zcosmic_workspace_handle_v1_send_name(resource, workspace->name);
+    if (workspace->info->name != NULL)
+        zcosmic_workspace_handle_v1_send_name(resource, workspace->info->name);
 
     if (version >= ZCOSMIC_WORKSPACE_HANDLE_V1_SET_TILING_STATE_SINCE_VERSION)
         zcosmic_workspace_handle_v1_send_tiling_state(resource, workspace->tiling_state);
@@ -437,19 +397,20 @@ static struct wl_resource* e_cosmic_workspace_create_resource(struct e_cosmic_wo
 }
 
 // Returns NULL on fail.
-struct e_cosmic_workspace* e_cosmic_workspace_create(struct e_cosmic_workspace_group* group)
+struct e_cosmic_workspace* e_cosmic_workspace_create(struct e_cosmic_workspace_group* group, struct e_workspace_info* info)
 {
+    assert(group && info);
+
     struct e_cosmic_workspace* workspace = calloc(1, sizeof(*workspace));
 
     if (workspace == NULL)
         return NULL;
 
-    workspace->name = NULL;
+    workspace->info = info;
+    workspace->state = info->state;
     workspace->group = group;
     workspace->tiling_state = E_COSMIC_WORKSPACE_TILING_STATE_FLOATING_ONLY;
 
-    wl_array_init(&workspace->coords);
-
     wl_list_init(&workspace->resources);
 
     wl_signal_init(&workspace->events.request_activate);
@@ -484,50 +445,25 @@ struct e_cosmic_workspace* e_cosmic_workspace_create(struct e_cosmic_workspace_g
     return workspace;
 }
 
-// Name is copied.
-void e_cosmic_workspace_set_name(struct e_cosmic_workspace* workspace, const char* name)
+// Sends changed fields of workspace's info to clients, state is sent with the next done event.
+// Changes is a bitmask of enum e_workspace_info_change.
+void e_cosmic_workspace_update(struct e_cosmic_workspace* workspace, uint32_t changes)
 {
     assert(workspace);
 
-    if (workspace == NULL)
-        return;
-
-    char* copy = e_strdup(name);
-
-    if (copy == NULL)
+    if (workspace == NULL || changes == 0)
         return;
 
-    if (workspace->name != NULL)
-        free(workspace->name);
-
-    workspace->name = copy;
+    struct e_workspace_info* info = workspace->info;
 
     struct wl_resource* resource;
     wl_list_for_each(resource, &workspace->resources, link)
     {
-        zcosmic_workspace_handle_v1_send_name(resource, copy);
-    }
-
-    e_cosmic_workspace_manager_schedule_done_event(workspace->group->manager);
-}
-
-// Set coordinates of the workspace.
-void e_cosmic_workspace_set_coords(struct e_cosmic_workspace* workspace, struct wl_array* coords)
-{
-    assert(workspace && coords);
-
-    if (workspace == NULL || coords == NULL)
-        return;
-
-    wl_array_release(&workspace->coords);
+        if ((changes & E_WORKSPACE_INFO_CHANGE_NAME) && info->name != NULL)
+            zcosmic_workspace_handle_v1_send_name(resource, info->name);
 
-    wl_array_init(&workspace->coords);
-    wl_array_copy(&workspace->coords, coords);
-
-    struct wl_resource* resource;
-    wl_list_for_each(resource, &workspace->resources, link)
-    {
-        zcosmic_workspace_handle_v1_send_coordinates(resource, &workspace->coords);
+        if (changes & E_WORKSPACE_INFO_CHANGE_COORDS)
+            zcosmic_workspace_handle_v1_send_coordinates(resource, &info->coords);
     }
 
     e_cosmic_workspace_manager_schedule_done_event(workspace->group->manager);
@@ -555,40 +491,6 @@ void e_cosmic_workspace_set_tiling_state(struct e_cosmic_workspace* workspace, e
     e_cosmic_workspace_manager_schedule_done_event(workspace->group->manager);
 }
 
-// Set whether or not workspace is in a specific state.
-static void workspace_set_state(struct e_cosmic_workspace* workspace, enum e_cosmic_workspace_state state, bool enabled)
-{
-    assert(workspace);
-
-    if (workspace == NULL)
-        return;
-
-    if (enabled)
-        workspace->pending_state |= state;
-    else
-        workspace->pending_state &= ~state;
-
-    e_cosmic_workspace_manager_schedule_done_event(workspace->group->manager);
-}
-
-// Set whether or not workspace is active.
-void e_cosmic_workspace_set_active(struct e_cosmic_workspace* workspace, bool active)
-{
-    workspace_set_state(workspace, E_COSMIC_WORKSPACE_STATE_ACTIVE, active);
-}
-
-// Set whether or not workspace wants attention.
-void e_cosmic_workspace_set_urgent(struct e_cosmic_workspace* workspace, bool urgent)
-{
-    workspace_set_state(workspace, E_COSMIC_WORKSPACE_STATE_URGENT, urgent);
-}
-
-// Set whether or not workspace is hidden.
-void e_cosmic_workspace_set_hidden(struct e_cosmic_workspace* workspace, bool hidden)
-{
-    workspace_set_state(workspace, E_COSMIC_WORKSPACE_STATE_HIDDEN, hidden);
-}
-
 // Destroys workspace.
 void e_cosmic_workspace_remove(struct e_cosmic_workspace* workspace)
 {
@@ -622,11 +524,6 @@ void e_cosmic_workspace_remove(struct e_cosmic_workspace* workspace)
 
     wl_list_remove(&workspace->link);
 
-    wl_array_release(&workspace->coords);
-
-    if (workspace->name != NULL)
-        free(workspace->name);
-
     free(workspace);
 }
 
@@ -639,6 +536,7 @@ struct group_create_workspace_event
     struct wl_listener destroy;
 };
 
+// Event is stored inside its operation, only its name needs freeing.
 static void group_create_workspace_event_destroy(struct wl_listener* listener, void* data)
 {
     struct group_create_workspace_event* event = wl_container_of(listener, event, destroy);
@@ -646,41 +544,32 @@ static void group_create_workspace_event_destroy(struct wl_listener* listener, v
     SIGNAL_DISCONNECT(event->destroy);
 
     free(event->name);
-
-    free(event);
 }
 
 static void e_cosmic_workspace_group_create_workspace(struct wl_client* client, struct wl_resource* resource, const char* workspace_name)
 {
     struct e_cosmic_workspace_group* group = wl_resource_get_user_data(resource);
 
-    struct group_create_workspace_event* event = calloc(1, sizeof(*event));
-
-    if (event == NULL)
-    {
-        wl_client_post_no_memory(client);
-        return;
-    }
-
-    event->name = e_strdup(workspace_name);
+    char* name = e_strdup(workspace_name);
 
-    if (event->name == NULL)
+    if (name == NULL)
     {
-        free(event);
         wl_client_post_no_memory(client);
         return;
     }
 
-    struct e_trans_op* operation = e_trans_session_add_op(&group->manager->trans_session, group, MANAGER_GROUP_CREATE_WORKSPACE, event);
+    struct e_trans_op* operation = e_trans_session_add_op_inline(&group->manager->trans_session, group, MANAGER_GROUP_CREATE_WORKSPACE, sizeof(struct group_create_workspace_event));
 
     if (operation == NULL)
     {
-        free(event->name);
-        free(event);
+        free(name);
         wl_client_post_no_memory(client);
         return;
     }
 
+    struct group_create_workspace_event* event = operation->data;
+    event->name = name;
+
     SIGNAL_CONNECT(operation->destroy, event->destroy, group_create_workspace_event_destroy);
 }
 
@@ -700,6 +589,11 @@ static const struct zcosmic_workspace_group_handle_v1_interface workspace_group_
 static void e_cosmic_workspace_group_resource_destroy(struct wl_resource* resource)
 {
     wl_list_remove(wl_resource_get_link(resource));
+
+    struct e_workspace_client* workspace_client = e_workspace_client_from_client(wl_resource_get_client(resource), &workspace_client_impl);
+
+    if (workspace_client != NULL)
+        e_workspace_client_remove_resource(&workspace_client->group_resources, resource);
 }
 
 // Returns NULL on fail.
@@ -715,6 +609,15 @@ static struct wl_resource* e_cosmic_workspace_group_create_resource(struct e_cos
         return NULL;
     }
 
+    struct e_workspace_client* workspace_client = e_workspace_client_from_client(client, &workspace_client_impl);
+
+    if (workspace_client == NULL || !e_workspace_client_add_resource(&workspace_client->group_resources, group_resource))
+    {
+        wl_resource_destroy(group_resource);
+        wl_client_post_no_memory(client);
+        return NULL;
+    }
+
     wl_resource_set_implementation(group_resource, &workspace_group_interface, group, e_cosmic_workspace_group_resource_destroy);
 
     wl_list_insert(&group->resources, wl_resource_get_link(group_resource));
@@ -798,16 +701,11 @@ void e_cosmic_workspace_group_output_enter(struct e_cosmic_workspace_group* grou
 
     wl_list_insert(&group->outputs, &group_output->link);
 
-    //send output enter using every group resource to every output resource
-    struct wl_resource* group_resource;
-    wl_list_for_each(group_resource, &group->resources, link)
+    //send output enter to group resources of each output resource's client
+    struct wl_resource* output_resource;
+    wl_list_for_each(output_resource, &output->resources, link)
     {
-        struct wl_resource* output_resource;
-        wl_list_for_each(output_resource, &output->resources, link)
-        {
-            if (wl_resource_get_client(group_resource) == wl_resource_get_client(output_resource))
-                zcosmic_workspace_group_handle_v1_send_output_enter(group_resource, output_resource);
-        }    
+        e_workspace_client_send_group_output_event(&workspace_client_impl, group, output_resource, true);
     }
 
     e_cosmic_workspace_manager_schedule_done_event(group->manager);
@@ -901,9 +799,9 @@ static void manager_idle_send_done_event(void* data)
         struct e_cosmic_workspace* workspace;
         wl_list_for_each(workspace, &group->workspaces, link)
         {
-            if (workspace->pending_state != workspace->state)
+            if (workspace->info->state != workspace->state)
             {
-                workspace->state = workspace->pending_state;
+                workspace->state = workspace->info->state;
                 workspace_send_state(workspace, NULL);
             }
         }   
@@ -932,18 +830,59 @@ static void e_cosmic_workspace_manager_schedule_done_event(struct e_cosmic_works
 
 /* workspace manager interface */
 
+// Returns true if operation wouldn't change anything.
+static bool cosmic_workspace_op_is_noop(struct e_trans_op* operation)
+{
+    struct e_cosmic_workspace* workspace;
+
+    switch (operation->type)
+    {
+        case MANAGER_WORKSPACE_ACTIVATE:
+            workspace = operation->src;
+            return workspace->info->state & E_WORKSPACE_INFO_STATE_ACTIVE;
+        case MANAGER_WORKSPACE_DEACTIVATE:
+            workspace = operation->src;
+            return !(workspace->info->state & E_WORKSPACE_INFO_STATE_ACTIVE);
+        case MANAGER_WORKSPACE_RENAME:
+            workspace = operation->src;
+            struct workspace_rename_event* rename_event = operation->data;
+            return workspace->info->name != NULL && strcmp(workspace->info->name, rename_event->name) == 0;
+        case MANAGER_WORKSPACE_SET_TILING_STATE:
+            workspace = operation->src;
+            struct e_cosmic_workspace_request_tiling_state_event* tiling_event = operation->data;
+            return tiling_event->tiling_state == workspace->tiling_state;
+        default:
+            return false;
+    }
+}
+
 // Handle all requested operations at once.
 static void e_cosmic_workspace_manager_commit(struct wl_client* client, struct wl_resource* resource)
 {
     struct e_cosmic_workspace_manager* manager = wl_resource_get_user_data(resource);
 
+    e_watchdog_section_begin("cosmic workspace commit");
+
     struct e_cosmic_workspace_group* group;
     struct e_cosmic_workspace* workspace;
 
+    //only the last activate or deactivate, remove, rename and tiling state request of a workspace matters
+    e_trans_session_keep_last(&manager->trans_session, (1 << MANAGER_WORKSPACE_ACTIVATE) | (1 << MANAGER_WORKSPACE_DEACTIVATE));
+    e_trans_session_keep_last(&manager->trans_session, 1 << MANAGER_WORKSPACE_REMOVE);
+    e_trans_session_keep_last(&manager->trans_session, 1 << MANAGER_WORKSPACE_RENAME);
+    e_trans_session_keep_last(&manager->trans_session, 1 << MANAGER_WORKSPACE_SET_TILING_STATE);
+
     struct e_trans_op* operation;
     struct e_trans_op* tmp;
     e_trans_session_for_each_safe(operation, tmp, &manager->trans_session)
     {
+        //drop requests that wouldn't change anything
+        if (cosmic_workspace_op_is_noop(operation))
+        {
+            e_trans_op_destroy(operation);
+            continue;
+        }
+
         switch(operation->type)
         {
             case MANAGER_GROUP_CREATE_WORKSPACE:
@@ -979,6 +918,8 @@ static void e_cosmic_workspace_manager_commit(struct wl_client* client, struct w
     }
 
     e_cosmic_workspace_manager_schedule_done_event(manager);
+
+    e_watchdog_section_end();
 }
 
 // Clients no longer wants to receive events.
@@ -998,6 +939,11 @@ static const struct zcosmic_workspace_manager_v1_interface workspace_manager_int
 static void e_cosmic_workspace_manager_resource_destroy(struct wl_resource* resource)
 {
     wl_list_remove(wl_resource_get_link(resource));
+
+    struct e_workspace_client* workspace_client = e_workspace_client_from_client(wl_resource_get_client(resource), &workspace_client_impl);
+
+    if (workspace_client != NULL)
+        e_workspace_client_remove_resource(&workspace_client->manager_resources, resource);
 }
 
 // Client wants to bind to manager's global.
@@ -1007,6 +953,21 @@ static void e_cosmic_workspace_manager_bind(struct wl_client* client, void* data
 
     struct wl_resource* resource = wl_resource_create(client, &zcosmic_workspace_manager_v1_interface, version, id);
 
+    if (resource == NULL)
+    {
+        wl_client_post_no_memory(client);
+        return;
+    }
+
+    struct e_workspace_client* workspace_client = e_workspace_client_get_or_create(client, &workspace_client_impl);
+
+    if (workspace_client == NULL || !e_workspace_client_add_resource(&workspace_client->manager_resources, resource))
+    {
+        wl_resource_destroy(resource);
+        wl_client_post_no_memory(client);
+        return;
+    }
+
     wl_resource_set_implementation(resource, &workspace_manager_interface, manager, e_cosmic_workspace_manager_resource_destroy);
     
     wl_list_insert(&manager->resources, wl_resource_get_link(resource));
@@ -1055,7 +1016,7 @@ static void e_cosmic_workspace_manager_display_destroy(struct wl_listener* liste
         e_cosmic_workspace_group_remove(group);
     }
 
-    e_trans_session_clear(&manager->trans_session);
+    e_trans_session_fini(&manager->trans_session);
     
     if (manager->done_idle_event != NULL)
         wl_event_source_remove(manager->done_idle_event);
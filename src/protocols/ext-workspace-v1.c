@@ -1,5 +1,6 @@
 #include "protocols/ext-workspace-v1.h"
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -13,9 +14,12 @@
 
 #include <wlr/types/wlr_output.h>
 
+#include "util/watchdog.h"
 #include "util/wl_macros.h"
 
 #include "protocols/transactions.h"
+#include "protocols/workspace-client.h"
+#include "protocols/workspace-info.h"
 
 #include "ext-workspace-v1-protocol.h"
 
@@ -67,6 +71,14 @@ static char* e_strdup(const char* string)
 
 static void e_ext_workspace_manager_schedule_done_event(struct e_ext_workspace_manager* manager);
 
+/* workspace client */
+
+static const struct e_workspace_client_impl workspace_client_impl = {
+    .send_manager_done = ext_workspace_manager_v1_send_done,
+    .send_group_output_enter = ext_workspace_group_handle_v1_send_output_enter,
+    .send_group_output_leave = ext_workspace_group_handle_v1_send_output_leave
+};
+
 /* group output */
 
 static void group_output_destroy(struct group_output* group_output)
@@ -76,16 +88,11 @@ static void group_output_destroy(struct group_output* group_output)
     if (group_output == NULL)
         return;
 
-    //send output enter using every group resource to every output resource
-    struct wl_resource* group_resource;
-    wl_list_for_each(group_resource, &group_output->group->resources, link)
+    //send output leave to group resources of each output resource's client
+    struct wl_resource* output_resource;
+    wl_list_for_each(output_resource, &group_output->output->resources, link)
     {
-        struct wl_resource* output_resource;
-        wl_list_for_each(output_resource, &group_output->output->resources, link)
-        {
-            if (wl_resource_get_client(group_resource) == wl_resource_get_client(output_resource))
-                ext_workspace_group_handle_v1_send_output_leave(group_resource, output_resource);
-        }    
+        e_workspace_client_send_group_output_event(&workspace_client_impl, group_output->group, output_resource, false);
     }
 
     SIGNAL_DISCONNECT(group_output->group_destroy);
@@ -112,34 +119,9 @@ static void group_output_output_bind(struct wl_listener* listener, void* data)
 
     struct wlr_output_event_bind* event = data;
 
-    //client that bound to output
-    struct wl_client* client = wl_resource_get_client(event->resource);
-
-    bool event_sent = false;
-
-    //TODO: Can there be multiple resources for the same client? I don't think there can be, but just in case it can happen, I won't break the loop.
-
-    //send output enter event to group resources for this client.
-    struct wl_resource* group_resource;
-    wl_list_for_each(group_resource, &group_output->group->resources, link)
-    {
-        if (wl_resource_get_client(group_resource) == client)
-        {
-            ext_workspace_group_handle_v1_send_output_enter(group_resource, event->resource);
-            event_sent = true;
-        }
-    }
-
-    if (!event_sent)
-        return;
-
-    //if we sent an event, send done event to manager resource for this client
-    struct wl_resource* manager_resource;
-    wl_list_for_each(manager_resource, &group_output->group->manager->resources, link)
-    {
-        if (wl_resource_get_client(manager_resource) == client)
-            ext_workspace_manager_v1_send_done(manager_resource);
-    }
+    //send output enter event to group resources for this client, if we sent any, send done event to this client
+    if (e_workspace_client_send_group_output_event(&workspace_client_impl, group_output->group, event->resource, true))
+        e_workspace_client_send_done(wl_resource_get_client(event->resource), &workspace_client_impl);
 }
 
 static void group_output_output_destroy(struct wl_listener* listener, void* data)
@@ -169,23 +151,13 @@ static struct group_output* group_output_from_wlr_output(struct e_ext_workspace_
 
 /* workspace interface */
 
+// Stored inside its operation.
 struct workspace_assign_event
 {
     // Group that workspace wants to be assigned to.
     struct e_ext_workspace_group* group;
-
-    struct wl_listener destroy;
 };
 
-void workspace_assign_event_destroy(struct wl_listener* listener, void* data)
-{
-    struct workspace_assign_event* event = wl_container_of(listener, event, destroy);
-
-    SIGNAL_DISCONNECT(event->destroy);
-
-    free(event);
-}
-
 static void e_ext_workspace_request_activate(struct wl_client* client, struct wl_resource* resource)
 {
     struct e_ext_workspace* workspace = wl_resource_get_user_data(resource);
@@ -201,27 +173,17 @@ static void e_ext_workspace_request_deactivate(struct wl_client* client, struct
 static void e_ext_workspace_request_assign(struct wl_client* client, struct wl_resource* resource, struct wl_resource* group_resource)
 {
     struct e_ext_workspace* workspace = wl_resource_get_user_data(resource);
-    struct workspace_assign_event* event = calloc(1, sizeof(*event));
 
-    if (event == NULL)
-    {
-        wl_client_post_no_memory(client);
-        return;
-    }
-
-    struct e_ext_workspace_group* group = wl_resource_get_user_data(group_resource);
-    event->group = group;
-
-    struct e_trans_op* operation = e_trans_session_add_op(&workspace->manager->trans_session, workspace, MANAGER_WORKSPACE_ASSIGN, event);
+    struct e_trans_op* operation = e_trans_session_add_op_inline(&workspace->manager->trans_session, workspace, MANAGER_WORKSPACE_ASSIGN, sizeof(struct workspace_assign_event));
 
     if (operation == NULL)
     {
-        free(event);
         wl_client_post_no_memory(client);
         return;
     }
 
-    SIGNAL_CONNECT(operation->destroy, event->destroy, workspace_assign_event_destroy);
+    struct workspace_assign_event* event = operation->data;
+    event->group = wl_resource_get_user_data(group_resource);
 }
 
 static void e_ext_workspace_request_remove(struct wl_client* client, struct wl_resource* resource)
@@ -257,13 +219,13 @@ static void workspace_send_state(struct e_ext_workspace* workspace, struct wl_re
 
     uint32_t state = 0;
 
-    if (workspace->state & E_EXT_WORKSPACE_STATE_ACTIVE)
+    if (workspace->state & E_WORKSPACE_INFO_STATE_ACTIVE)
         state |= EXT_WORKSPACE_HANDLE_V1_STATE_ACTIVE;
 
-    if (workspace->state & E_EXT_WORKSPACE_STATE_URGENT)
+    if (workspace->state & E_WORKSPACE_INFO_STATE_URGENT)
         state |= EXT_WORKSPACE_HANDLE_V1_STATE_URGENT;
 
-    if (workspace->state & E_EXT_WORKSPACE_STATE_HIDDEN)
+    if (workspace->state & E_WORKSPACE_INFO_STATE_HIDDEN)
         state |= EXT_WORKSPACE_HANDLE_V1_STATE_HIDDEN;
 
     if (resource != NULL)
@@ -319,11 +281,11 @@ static void workspace_resource_send_init(struct e_ext_workspace* workspace, stru
 
     workspace_resource_send_capabilities(workspace, resource);
 
-    if (workspace->coords.size != 0)
-        ext_workspace_handle_v1_send_coordinates(resource, &workspace->coords);
+    if (workspace->info->coords.size != 0)
+        ext_workspace_handle_v1_send_coordinates(resource, &workspace->info->coords);
 
-    if (workspace->name != NULL)
-        ext_workspace_handle_v1_send_name(resource, workspace->name);
+    if (workspace->info->name != NULL)
+        ext_workspace_handle_v1_send_name(resource, workspace->info->name);
 }
 
 static void e_ext_workspace_resource_destroy(struct wl_resource* resource)
@@ -352,20 +314,21 @@ static struct wl_resource* e_ext_workspace_create_resource(struct e_ext_workspac
 }
 
 // Returns NULL on fail.
-struct e_ext_workspace* e_ext_workspace_create(struct e_ext_workspace_manager* manager, const char* id)
+struct e_ext_workspace* e_ext_workspace_create(struct e_ext_workspace_manager* manager, const char* id, struct e_workspace_info* info)
 {
+    assert(manager && info);
+
     struct e_ext_workspace* workspace = calloc(1, sizeof(*workspace));
 
     if (workspace == NULL)
         return NULL;
 
     workspace->manager = manager;
-    workspace->name = NULL;
+    workspace->info = info;
+    workspace->state = info->state;
     workspace->id = (id != NULL) ? e_strdup(id) : NULL;
     workspace->group = NULL;
 
-    wl_array_init(&workspace->coords);
-
     wl_list_init(&workspace->resources);
 
     wl_signal_init(&workspace->events.request_activate);
@@ -463,87 +426,28 @@ void e_ext_workspace_assign_to_group(struct e_ext_workspace* workspace, struct e
     e_ext_workspace_manager_schedule_done_event(workspace->manager);
 }
 
-// Name is copied.
-void e_ext_workspace_set_name(struct e_ext_workspace* workspace, const char* name)
+// Sends changed fields of workspace's info to clients, state is sent with the next done event.
+// Changes is a bitmask of enum e_workspace_info_change.
+void e_ext_workspace_update(struct e_ext_workspace* workspace, uint32_t changes)
 {
     assert(workspace);
 
-    if (workspace == NULL)
-        return;
-
-    char* copy = e_strdup(name);
-
-    if (copy == NULL)
+    if (workspace == NULL || changes == 0)
         return;
 
-    if (workspace->name != NULL)
-        free(workspace->name);
-
-    workspace->name = copy;
+    struct e_workspace_info* info = workspace->info;
 
     struct wl_resource* resource;
     wl_list_for_each(resource, &workspace->resources, link)
     {
-        ext_workspace_handle_v1_send_name(resource, copy);
-    }
-
-    e_ext_workspace_manager_schedule_done_event(workspace->manager);
-}
-
-// Set coordinates of the workspace.
-void e_ext_workspace_set_coords(struct e_ext_workspace* workspace, struct wl_array* coords)
-{
-    assert(workspace && coords);
+        if ((changes & E_WORKSPACE_INFO_CHANGE_NAME) && info->name != NULL)
+            ext_workspace_handle_v1_send_name(resource, info->name);
 
-    if (workspace == NULL || coords == NULL)
-        return;
-
-    wl_array_release(&workspace->coords);
-
-    wl_array_init(&workspace->coords);
-    wl_array_copy(&workspace->coords, coords);
-
-    struct wl_resource* resource;
-    wl_list_for_each(resource, &workspace->resources, link)
-    {
-        ext_workspace_handle_v1_send_coordinates(resource, &workspace->coords);
+        if (changes & E_WORKSPACE_INFO_CHANGE_COORDS)
+            ext_workspace_handle_v1_send_coordinates(resource, &info->coords);
     }
 
-    e_ext_workspace_manager_schedule_done_event(workspace->group->manager);
-}
-
-// Set whether or not workspace is in a specific state.
-static void workspace_set_state(struct e_ext_workspace* workspace, enum e_ext_workspace_state state, bool enabled)
-{
-    assert(workspace);
-
-    if (workspace == NULL)
-        return;
-
-    if (enabled)
-        workspace->pending_state |= state;
-    else
-        workspace->pending_state &= ~state;
-
-    e_ext_workspace_manager_schedule_done_event(workspace->group->manager);
-}
-
-// Set whether or not workspace is active.
-void e_ext_workspace_set_active(struct e_ext_workspace* workspace, bool active)
-{
-    workspace_set_state(workspace, E_EXT_WORKSPACE_STATE_ACTIVE, active);
-}
-
-// Set whether or not workspace wants attention.
-void e_ext_workspace_set_urgent(struct e_ext_workspace* workspace, bool urgent)
-{
-    workspace_set_state(workspace, E_EXT_WORKSPACE_STATE_URGENT, urgent);
-}
-
-// Set whether or not workspace is hidden.
-void e_ext_workspace_set_hidden(struct e_ext_workspace* workspace, bool hidden)
-{
-    workspace_set_state(workspace, E_EXT_WORKSPACE_STATE_HIDDEN, hidden);
+    e_ext_workspace_manager_schedule_done_event(workspace->manager);
 }
 
 // Destroys workspace.
@@ -582,11 +486,6 @@ void e_ext_workspace_remove(struct e_ext_workspace* workspace)
 
     wl_list_remove(&workspace->manager_link);
 
-    wl_array_release(&workspace->coords);
-
-    if (workspace->name != NULL)
-        free(workspace->name);
-
     if (workspace->id != NULL)
         free(workspace->id);
 
@@ -602,6 +501,7 @@ struct group_create_workspace_event
     struct wl_listener destroy;
 };
 
+// Event is stored inside its operation, only its name needs freeing.
 static void group_create_workspace_event_destroy(struct wl_listener* listener, void* data)
 {
     struct group_create_workspace_event* event = wl_container_of(listener, event, destroy);
@@ -609,41 +509,32 @@ static void group_create_workspace_event_destroy(struct wl_listener* listener, v
     SIGNAL_DISCONNECT(event->destroy);
 
     free(event->name);
-
-    free(event);
 }
 
 static void e_ext_workspace_group_create_workspace(struct wl_client* client, struct wl_resource* resource, const char* workspace_name)
 {
     struct e_ext_workspace_group* group = wl_resource_get_user_data(resource);
 
-    struct group_create_workspace_event* event = calloc(1, sizeof(*event));
-
-    if (event == NULL)
-    {
-        wl_client_post_no_memory(client);
-        return;
-    }
+    char* name = e_strdup(workspace_name);
 
-    event->name = e_strdup(workspace_name);
-
-    if (event->name == NULL)
+    if (name == NULL)
     {
-        free(event);
         wl_client_post_no_memory(client);
         return;
     }
 
-    struct e_trans_op* operation = e_trans_session_add_op(&group->manager->trans_session, group, MANAGER_GROUP_CREATE_WORKSPACE, event);
+    struct e_trans_op* operation = e_trans_session_add_op_inline(&group->manager->trans_session, group, MANAGER_GROUP_CREATE_WORKSPACE, sizeof(struct group_create_workspace_event));
 
     if (operation == NULL)
     {
-        free(event->name);
-        free(event);
+        free(name);
         wl_client_post_no_memory(client);
         return;
     }
 
+    struct group_create_workspace_event* event = operation->data;
+    event->name = name;
+
     SIGNAL_CONNECT(operation->destroy, event->destroy, group_create_workspace_event_destroy);
 }
 
@@ -680,6 +571,11 @@ static void group_resource_send_capabilities(struct e_ext_workspace_group* group
 static void e_ext_workspace_group_resource_destroy(struct wl_resource* resource)
 {
     wl_list_remove(wl_resource_get_link(resource));
+
+    struct e_workspace_client* workspace_client = e_workspace_client_from_client(wl_resource_get_client(resource), &workspace_client_impl);
+
+    if (workspace_client != NULL)
+        e_workspace_client_remove_resource(&workspace_client->group_resources, resource);
 }
 
 // Returns NULL on fail.
@@ -695,6 +591,15 @@ static struct wl_resource* e_ext_workspace_group_create_resource(struct e_ext_wo
         return NULL;
     }
 
+    struct e_workspace_client* workspace_client = e_workspace_client_from_client(client, &workspace_client_impl);
+
+    if (workspace_client == NULL || !e_workspace_client_add_resource(&workspace_client->group_resources, group_resource))
+    {
+        wl_resource_destroy(group_resource);
+        wl_client_post_no_memory(client);
+        return NULL;
+    }
+
     wl_resource_set_implementation(group_resource, &workspace_group_interface, group, e_ext_workspace_group_resource_destroy);
 
     wl_list_insert(&group->resources, wl_resource_get_link(group_resource));
@@ -765,16 +670,11 @@ void e_ext_workspace_group_output_enter(struct e_ext_workspace_group* group, str
 
     wl_list_insert(&group->outputs, &group_output->link);
 
-    //send output enter using every group resource to every output resource
-    struct wl_resource* group_resource;
-    wl_list_for_each(group_resource, &group->resources, link)
+    //send output enter to group resources of each output resource's client
+    struct wl_resource* output_resource;
+    wl_list_for_each(output_resource, &output->resources, link)
     {
-        struct wl_resource* output_resource;
-        wl_list_for_each(output_resource, &output->resources, link)
-        {
-            if (wl_resource_get_client(group_resource) == wl_resource_get_client(output_resource))
-                ext_workspace_group_handle_v1_send_output_enter(group_resource, output_resource);
-        }    
+        e_workspace_client_send_group_output_event(&workspace_client_impl, group, output_resource, true);
     }
 
     e_ext_workspace_manager_schedule_done_event(group->manager);
@@ -862,9 +762,9 @@ static void manager_idle_send_done_event(void* data)
     struct e_ext_workspace* workspace;
     wl_list_for_each(workspace, &manager->workspaces, manager_link)
     {
-        if (workspace->pending_state != workspace->state)
+        if (workspace->info->state != workspace->state)
         {
-            workspace->state = workspace->pending_state;
+            workspace->state = workspace->info->state;
             workspace_send_state(workspace, NULL);
         }
     }
@@ -892,18 +792,54 @@ static void e_ext_workspace_manager_schedule_done_event(struct e_ext_workspace_m
 
 /* workspace manager interface */
 
+// Returns true if operation wouldn't change anything.
+static bool ext_workspace_op_is_noop(struct e_trans_op* operation)
+{
+    struct e_ext_workspace* workspace;
+
+    switch (operation->type)
+    {
+        case MANAGER_WORKSPACE_ACTIVATE:
+            workspace = operation->src;
+            return workspace->info->state & E_WORKSPACE_INFO_STATE_ACTIVE;
+        case MANAGER_WORKSPACE_DEACTIVATE:
+            workspace = operation->src;
+            return !(workspace->info->state & E_WORKSPACE_INFO_STATE_ACTIVE);
+        case MANAGER_WORKSPACE_ASSIGN:
+            workspace = operation->src;
+            struct workspace_assign_event* event = operation->data;
+            return event->group == workspace->group;
+        default:
+            return false;
+    }
+}
+
 // Handle all requested operations at once.
 static void e_ext_workspace_manager_commit(struct wl_client* client, struct wl_resource* resource)
 {
     struct e_ext_workspace_manager* manager = wl_resource_get_user_data(resource);
 
+    e_watchdog_section_begin("ext workspace commit");
+
     struct e_ext_workspace_group* group;
     struct e_ext_workspace* workspace;
 
+    //only the last activate or deactivate, assign and remove request of a workspace matters
+    e_trans_session_keep_last(&manager->trans_session, (1 << MANAGER_WORKSPACE_ACTIVATE) | (1 << MANAGER_WORKSPACE_DEACTIVATE));
+    e_trans_session_keep_last(&manager->trans_session, 1 << MANAGER_WORKSPACE_ASSIGN);
+    e_trans_session_keep_last(&manager->trans_session, 1 << MANAGER_WORKSPACE_REMOVE);
+
     struct e_trans_op* operation;
     struct e_trans_op* tmp;
     e_trans_session_for_each_safe(operation, tmp, &manager->trans_session)
     {
+        //drop requests that wouldn't change anything
+        if (ext_workspace_op_is_noop(operation))
+        {
+            e_trans_op_destroy(operation);
+            continue;
+        }
+
         switch(operation->type)
         {
             case MANAGER_GROUP_CREATE_WORKSPACE:
@@ -934,6 +870,8 @@ static void e_ext_workspace_manager_commit(struct wl_client* client, struct wl_r
     }
 
     e_ext_workspace_manager_schedule_done_event(manager);
+
+    e_watchdog_section_end();
 }
 
 // Clients no longer wants to receive events.
@@ -954,6 +892,11 @@ static const struct ext_workspace_manager_v1_interface workspace_manager_interfa
 static void e_ext_workspace_manager_resource_destroy(struct wl_resource* resource)
 {
     wl_list_remove(wl_resource_get_link(resource));
+
+    struct e_workspace_client* workspace_client = e_workspace_client_from_client(wl_resource_get_client(resource), &workspace_client_impl);
+
+    if (workspace_client != NULL)
+        e_workspace_client_remove_resource(&workspace_client->manager_resources, resource);
 }
 
 // Client wants to bind to manager's global.
@@ -963,6 +906,21 @@ static void e_ext_workspace_manager_bind(struct wl_client* client, void* data, u
 
     struct wl_resource* resource = wl_resource_create(client, &ext_workspace_manager_v1_interface, version, id);
 
+    if (resource == NULL)
+    {
+        wl_client_post_no_memory(client);
+        return;
+    }
+
+    struct e_workspace_client* workspace_client = e_workspace_client_get_or_create(client, &workspace_client_impl);
+
+    if (workspace_client == NULL || !e_workspace_client_add_resource(&workspace_client->manager_resources, resource))
+    {
+        wl_resource_destroy(resource);
+        wl_client_post_no_memory(client);
+        return;
+    }
+
     wl_resource_set_implementation(resource, &workspace_manager_interface, manager, e_ext_workspace_manager_resource_destroy);
     
     wl_list_insert(&manager->resources, wl_resource_get_link(resource));
@@ -998,11 +956,11 @@ static void e_ext_workspace_manager_bind(struct wl_client* client, void* data, u
         if (workspace->group == NULL)
             continue;
 
-        struct wl_resource* group_resource;
-        wl_list_for_each(group_resource, &workspace->group->resources, link)
+        struct wl_resource** group_resource;
+        wl_array_for_each(group_resource, &workspace_client->group_resources)
         {
-            if (wl_resource_get_client(group_resource) == client)
-                ext_workspace_group_handle_v1_send_workspace_enter(group_resource, workspace_resource);
+            if (wl_resource_get_user_data(*group_resource) == workspace->group)
+                ext_workspace_group_handle_v1_send_workspace_enter(*group_resource, workspace_resource);
         }
     }
 
@@ -1031,7 +989,7 @@ static void e_ext_workspace_manager_display_destroy(struct wl_listener* listener
         e_ext_workspace_remove(workspace);
     }
 
-    e_trans_session_clear(&manager->trans_session);
+    e_trans_session_fini(&manager->trans_session);
 
     if (manager->done_idle_event != NULL)
         wl_event_source_remove(manager->done_idle_event);
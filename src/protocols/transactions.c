@@ -1,6 +1,9 @@
 #include "protocols/transactions.h"
 
+#include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
+#include <assert.h>
 
 #include <wayland-server-core.h>
 #include <wayland-util.h>
@@ -11,6 +14,26 @@
 void e_trans_session_init(struct e_trans_session* session)
 {
     wl_list_init(&session->operations);
+
+    wl_list_init(&session->free_operations);
+    session->free_count = 0;
+}
+
+// Returns a reused or newly allocated operation, not yet inside any list.
+// Returns NULL on fail.
+static struct e_trans_op* trans_session_take_op(struct e_trans_session* session)
+{
+    if (session->free_count > 0)
+    {
+        struct e_trans_op* op = wl_container_of(session->free_operations.next, op, link);
+        wl_list_remove(&op->link);
+        session->free_count--;
+
+        memset(op, 0, sizeof(*op));
+        return op;
+    }
+
+    return calloc(1, sizeof(struct e_trans_op));
 }
 
 // Creates a new operation for current transaction in session.
@@ -20,11 +43,12 @@ struct e_trans_op* e_trans_session_add_op(struct e_trans_session* session, void*
     if (session == NULL)
         return NULL;
 
-    struct e_trans_op* op = calloc(1, sizeof(*op));
+    struct e_trans_op* op = trans_session_take_op(session);
 
     if (op == NULL)
         return NULL;
 
+    op->session = session;
     op->type = type;
     op->src = src;
     op->data = data;
@@ -36,6 +60,53 @@ struct e_trans_op* e_trans_session_add_op(struct e_trans_session* session, void*
     return op;
 }
 
+// Creates a new operation for current transaction in session, with data of given size stored inside the operation.
+// Data is zeroed and must be filled in by caller, size must be at most E_TRANS_OP_INLINE_DATA_SIZE.
+// Returns NULL on fail.
+struct e_trans_op* e_trans_session_add_op_inline(struct e_trans_session* session, void* src, uint32_t type, size_t size)
+{
+    assert(size <= E_TRANS_OP_INLINE_DATA_SIZE);
+
+    if (size > E_TRANS_OP_INLINE_DATA_SIZE)
+        return NULL;
+
+    struct e_trans_op* op = e_trans_session_add_op(session, src, type, NULL);
+
+    if (op == NULL)
+        return NULL;
+
+    op->data = op->inline_data;
+
+    return op;
+}
+
+// Destroys every operation that has a later operation with the same src, where both their types are in types.
+// Types is a bitmask of (1 << type), so only the last of those operations is left for each src.
+void e_trans_session_keep_last(struct e_trans_session* session, uint32_t types)
+{
+    assert(session);
+
+    struct e_trans_op* op;
+    struct e_trans_op* tmp;
+    e_trans_session_for_each_safe(op, tmp, session)
+    {
+        if (op->type >= 32 || !(types & (1u << op->type)))
+            continue;
+
+        //look for a later operation that overrides this one
+        for (struct wl_list* pos = op->link.next; pos != &session->operations; pos = pos->next)
+        {
+            struct e_trans_op* later = wl_container_of(pos, later, link);
+
+            if (later->src == op->src && later->type < 32 && (types & (1u << later->type)))
+            {
+                e_trans_op_destroy(op);
+                break;
+            }
+        }
+    }
+}
+
 // Destroy all current operations inside session, basically starting a new transaction.
 void e_trans_session_clear(struct e_trans_session* session)
 {
@@ -47,7 +118,23 @@ void e_trans_session_clear(struct e_trans_session* session)
     }
 }
 
-// Frees e_trans_op and emits the destroy signal. To destroy data, use the destroy signal.
+// Destroys all operations and frees operations kept for reuse.
+void e_trans_session_fini(struct e_trans_session* session)
+{
+    e_trans_session_clear(session);
+
+    struct e_trans_op* op;
+    struct e_trans_op* tmp;
+    wl_list_for_each_safe(op, tmp, &session->free_operations, link)
+    {
+        wl_list_remove(&op->link);
+        free(op);
+    }
+
+    session->free_count = 0;
+}
+
+// Emits the destroy signal and returns operation to its session for reuse, or frees it. To destroy data, use the destroy signal.
 void e_trans_op_destroy(struct e_trans_op* operation)
 {
     if (operation == NULL)
@@ -57,5 +144,14 @@ void e_trans_op_destroy(struct e_trans_op* operation)
 
     wl_list_remove(&operation->link);
 
+    struct e_trans_session* session = operation->session;
+
+    if (session != NULL && session->free_count < E_TRANS_SESSION_MAX_FREE_OPS)
+    {
+        wl_list_insert(&session->free_operations, &operation->link);
+        session->free_count++;
+        return;
+    }
+
     free(operation);
-}
\ No newline at end of file
+}
@@ -0,0 +1,191 @@
+#include "protocols/workspace-client.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include <wayland-server-core.h>
+#include <wayland-util.h>
+
+#include "util/wl_macros.h"
+
+// Workspace clients of a wayland client, found through its destroy listener, so there is at most one per client.
+struct workspace_clients
+{
+    struct wl_list clients; //struct e_workspace_client*
+
+    struct wl_listener client_destroy;
+};
+
+static void workspace_clients_handle_client_destroy(struct wl_listener* listener, void* data)
+{
+    struct workspace_clients* workspace_clients = wl_container_of(listener, workspace_clients, client_destroy);
+
+    SIGNAL_DISCONNECT(workspace_clients->client_destroy);
+
+    struct e_workspace_client* workspace_client;
+    struct e_workspace_client* tmp;
+    wl_list_for_each_safe(workspace_client, tmp, &workspace_clients->clients, link)
+    {
+        wl_array_release(&workspace_client->manager_resources);
+        wl_array_release(&workspace_client->group_resources);
+
+        wl_list_remove(&workspace_client->link);
+        free(workspace_client);
+    }
+
+    free(workspace_clients);
+}
+
+// Returns NULL if client has no resources of any workspace protocol, or client is being destroyed.
+static struct workspace_clients* workspace_clients_from_client(struct wl_client* client)
+{
+    struct wl_listener* listener = wl_client_get_destroy_listener(client, workspace_clients_handle_client_destroy);
+
+    if (listener == NULL)
+        return NULL;
+
+    struct workspace_clients* workspace_clients = wl_container_of(listener, workspace_clients, client_destroy);
+
+    return workspace_clients;
+}
+
+// Returns NULL if client has no resources of protocol, or client is being destroyed.
+struct e_workspace_client* e_workspace_client_from_client(struct wl_client* client, const struct e_workspace_client_impl* impl)
+{
+    assert(client && impl);
+
+    struct workspace_clients* workspace_clients = workspace_clients_from_client(client);
+
+    if (workspace_clients == NULL)
+        return NULL;
+
+    //one per protocol
+    struct e_workspace_client* workspace_client;
+    wl_list_for_each(workspace_client, &workspace_clients->clients, link)
+    {
+        if (workspace_client->impl == impl)
+            return workspace_client;
+    }
+
+    return NULL;
+}
+
+// Returns NULL on fail.
+struct e_workspace_client* e_workspace_client_get_or_create(struct wl_client* client, const struct e_workspace_client_impl* impl)
+{
+    assert(client && impl);
+
+    struct e_workspace_client* workspace_client = e_workspace_client_from_client(client, impl);
+
+    if (workspace_client != NULL)
+        return workspace_client;
+
+    struct workspace_clients* workspace_clients = workspace_clients_from_client(client);
+
+    if (workspace_clients == NULL)
+    {
+        workspace_clients = calloc(1, sizeof(*workspace_clients));
+
+        if (workspace_clients == NULL)
+            return NULL;
+
+        wl_list_init(&workspace_clients->clients);
+
+        workspace_clients->client_destroy.notify = workspace_clients_handle_client_destroy;
+        wl_client_add_destroy_listener(client, &workspace_clients->client_destroy);
+    }
+
+    workspace_client = calloc(1, sizeof(*workspace_client));
+
+    if (workspace_client == NULL)
+        return NULL;
+
+    workspace_client->impl = impl;
+
+    wl_array_init(&workspace_client->manager_resources);
+    wl_array_init(&workspace_client->group_resources);
+
+    wl_list_insert(&workspace_clients->clients, &workspace_client->link);
+
+    return workspace_client;
+}
+
+// Returns true on success, false on fail.
+bool e_workspace_client_add_resource(struct wl_array* resources, struct wl_resource* resource)
+{
+    assert(resources && resource);
+
+    struct wl_resource** slot = wl_array_add(resources, sizeof(*slot));
+
+    if (slot == NULL)
+        return false;
+
+    *slot = resource;
+    return true;
+}
+
+void e_workspace_client_remove_resource(struct wl_array* resources, struct wl_resource* resource)
+{
+    assert(resources && resource);
+
+    struct wl_resource** array = resources->data;
+    size_t count = resources->size / sizeof(*array);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (array[i] != resource)
+            continue;
+
+        //order doesn't matter, move last into its place
+        array[i] = array[count - 1];
+        resources->size -= sizeof(*array);
+        return;
+    }
+}
+
+// Sends done event to every manager resource of client.
+void e_workspace_client_send_done(struct wl_client* client, const struct e_workspace_client_impl* impl)
+{
+    struct e_workspace_client* workspace_client = e_workspace_client_from_client(client, impl);
+
+    if (workspace_client == NULL)
+        return;
+
+    struct wl_resource** manager_resource;
+    wl_array_for_each(manager_resource, &workspace_client->manager_resources)
+    {
+        impl->send_manager_done(*manager_resource);
+    }
+}
+
+// Sends output enter or leave event for output resource to the group's resources of the same client.
+// Group is the user data of its resources.
+// Returns true if any event was sent.
+bool e_workspace_client_send_group_output_event(const struct e_workspace_client_impl* impl, void* group, struct wl_resource* output_resource, bool enter)
+{
+    struct e_workspace_client* workspace_client = e_workspace_client_from_client(wl_resource_get_client(output_resource), impl);
+
+    if (workspace_client == NULL)
+        return false;
+
+    bool event_sent = false;
+
+    struct wl_resource** group_resource;
+    wl_array_for_each(group_resource, &workspace_client->group_resources)
+    {
+        //removed groups' resources have no group
+        if (wl_resource_get_user_data(*group_resource) != group)
+            continue;
+
+        if (enter)
+            impl->send_group_output_enter(*group_resource, output_resource);
+        else
+            impl->send_group_output_leave(*group_resource, output_resource);
+
+        event_sent = true;
+    }
+
+    return event_sent;
+}
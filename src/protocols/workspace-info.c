@@ -0,0 +1,90 @@
+#include "protocols/workspace-info.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <wayland-util.h>
+
+void e_workspace_info_init(struct e_workspace_info* info)
+{
+    assert(info);
+
+    info->name = NULL;
+    wl_array_init(&info->coords);
+    info->state = 0;
+}
+
+// Name is copied.
+// Returns bitmask of enum e_workspace_info_change, 0 if nothing changed.
+uint32_t e_workspace_info_set_name(struct e_workspace_info* info, const char* name)
+{
+    assert(info && name);
+
+    if (info == NULL || name == NULL)
+        return 0;
+
+    if (info->name != NULL && strcmp(info->name, name) == 0)
+        return 0;
+
+    char* copy = strdup(name);
+
+    if (copy == NULL)
+        return 0;
+
+    free(info->name);
+    info->name = copy;
+
+    return E_WORKSPACE_INFO_CHANGE_NAME;
+}
+
+// Coords are copied.
+// Returns bitmask of enum e_workspace_info_change, 0 if nothing changed.
+uint32_t e_workspace_info_set_coords(struct e_workspace_info* info, struct wl_array* coords)
+{
+    assert(info && coords);
+
+    if (info == NULL || coords == NULL)
+        return 0;
+
+    if (info->coords.size == coords->size && (coords->size == 0 || memcmp(info->coords.data, coords->data, coords->size) == 0))
+        return 0;
+
+    wl_array_release(&info->coords);
+    wl_array_init(&info->coords);
+
+    wl_array_copy(&info->coords, coords);
+
+    return E_WORKSPACE_INFO_CHANGE_COORDS;
+}
+
+// Set whether or not workspace is in a specific state.
+// Returns bitmask of enum e_workspace_info_change, 0 if nothing changed.
+uint32_t e_workspace_info_set_state(struct e_workspace_info* info, enum e_workspace_info_state state, bool enabled)
+{
+    assert(info);
+
+    if (info == NULL)
+        return 0;
+
+    uint32_t new_state = enabled ? (info->state | state) : (info->state & ~(uint32_t)state);
+
+    if (new_state == info->state)
+        return 0;
+
+    info->state = new_state;
+
+    return E_WORKSPACE_INFO_CHANGE_STATE;
+}
+
+void e_workspace_info_fini(struct e_workspace_info* info)
+{
+    assert(info);
+
+    free(info->name);
+    info->name = NULL;
+
+    wl_array_release(&info->coords);
+}
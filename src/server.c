@@ -1,8 +1,13 @@
 #include "server.h"
 
 #include <signal.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <poll.h>
+#include <unistd.h>
 
 #include <wayland-server-core.h>
 #include <wayland-util.h>
@@ -22,6 +27,7 @@
 #include <wlr/types/wlr_seat.h>
 #include <wlr/types/wlr_xdg_output_v1.h>
 #include <wlr/types/wlr_viewporter.h>
+#include <wlr/types/wlr_fractional_scale_v1.h>
 #include <wlr/types/wlr_presentation_time.h>
 #include <wlr/types/wlr_primary_selection_v1.h>
 #include <wlr/types/wlr_data_control_v1.h>
@@ -42,9 +48,14 @@
 #include <wlr/xwayland.h>
 #endif
 
+#include "desktop/client.h"
 #include "desktop/output.h"
 
 #include "util/log.h"
+#include "util/thread_pool.h"
+#include "util/time.h"
+#include "util/trace.h"
+#include "util/watchdog.h"
 #include "util/wl_macros.h"
 
 #include "input/seat.h"
@@ -54,6 +65,12 @@
 
 #include "config.h"
 
+// Max time to wait for the first frame before creating deferred globals anyway.
+#define DEFERRED_GLOBALS_TIMEOUT_MS 1000
+
+// Amount of threads running blocking work like compiling keymaps.
+#define WORKER_THREAD_COUNT 2
+
 static bool e_server_init_scene(struct e_server* server)
 {
     assert(server && server->display && server->output_layout);
@@ -101,6 +118,29 @@ static int e_server_handle_signal_terminate(int signal, void* data)
     return 0;
 }
 
+#if E_TRACE
+// Export recorded trace events to $XDG_RUNTIME_DIR/estrogenwl-trace-<pid>.json.
+static int e_server_handle_signal_trace_export(int signal, void* data)
+{
+    const char* runtime_dir = getenv("XDG_RUNTIME_DIR");
+
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/estrogenwl-trace-%i.json", (runtime_dir != NULL) ? runtime_dir : "/tmp", (int)getpid());
+
+    e_trace_export(path);
+    return 0;
+}
+#endif
+
+// Log resource usage of clients, to find clients using the most memory.
+static int e_server_handle_signal_log_clients(int signal, void* data)
+{
+    struct e_server* server = data;
+
+    e_server_log_clients(server);
+    return 0;
+}
+
 static void e_server_new_input(struct wl_listener* listener, void* data)
 {
     struct e_server* server = wl_container_of(listener, server, new_input);
@@ -159,6 +199,97 @@ static void e_server_renderer_lost(struct wl_listener* listener, void* data)
     }
 }
 
+// Logs time spent since previous startup phase ended, and total time since startup began.
+void e_server_startup_phase(struct e_server* server, const char* phase)
+{
+    assert(server && phase);
+
+    if (server == NULL || phase == NULL)
+        return;
+
+    struct timespec now = e_time_now();
+
+    e_log_info("startup: %s took %.2f ms (%.2f ms total)", phase, e_time_diff_ms(&server->startup.last_phase, &now), e_time_diff_ms(&server->startup.start, &now));
+
+    server->startup.last_phase = now;
+}
+
+// Creates globals that aren't needed for the first frame, and emits ready.
+static void server_init_deferred(struct e_server* server)
+{
+    if (server->startup.deferred_done)
+        return;
+
+    server->startup.deferred_done = true;
+
+    if (server->sources.deferred_timeout != NULL)
+    {
+        wl_event_source_remove(server->sources.deferred_timeout);
+        server->sources.deferred_timeout = NULL;
+    }
+
+    //allows clients to control selection and take the role of a clipboard manager
+    if (wlr_data_control_manager_v1_create(server->display) == NULL)
+        e_log_error("server_init_deferred: failed to create wlr data control manager v1");
+
+    if (wlr_ext_data_control_manager_v1_create(server->display, E_EXT_DATA_CONTROL_V1_VERSION) == NULL)
+        e_log_error("server_init_deferred: failed to create wlr ext data control manager v1");
+
+    e_server_init_output_capture(server);
+
+    //allows clients to reference surfaces of other clients
+    struct wlr_xdg_foreign_registry* foreign_registry = wlr_xdg_foreign_registry_create(server->display);
+
+    if (foreign_registry != NULL)
+    {
+        wlr_xdg_foreign_v1_create(server->display, foreign_registry);
+        wlr_xdg_foreign_v2_create(server->display, foreign_registry);
+    }
+    else
+    {
+        e_log_error("server_init_deferred: failed to create wlr xdg foreign registry");
+    }
+
+    e_server_startup_phase(server, "deferred globals");
+
+    wl_signal_emit_mutable(&server->events.ready, server);
+}
+
+static void server_handle_first_frame_idle(void* data)
+{
+    struct e_server* server = data;
+
+    server_init_deferred(server);
+}
+
+static int server_handle_deferred_timeout(void* data)
+{
+    struct e_server* server = data;
+
+    e_log_info("startup: no frame presented after %i ms, creating deferred globals anyway", DEFERRED_GLOBALS_TIMEOUT_MS);
+    server_init_deferred(server);
+
+    return 0;
+}
+
+// Call when an output has committed a frame.
+// Globals that weren't needed for the first frame are created after the first one.
+void e_server_handle_output_frame(struct e_server* server)
+{
+    assert(server);
+
+    if (server == NULL || server->startup.first_frame)
+        return;
+
+    server->startup.first_frame = true;
+
+    e_server_startup_phase(server, "first frame");
+
+    //don't delay presenting the first frame any further
+    if (wl_event_loop_add_idle(server->event_loop, server_handle_first_frame_idle, server) == NULL)
+        server_init_deferred(server);
+}
+
 int e_server_init(struct e_server* server, struct e_config* config)
 {
     assert(server && config);
@@ -168,6 +299,11 @@ int e_server_init(struct e_server* server, struct e_config* config)
 
     server->config = config;
 
+    server->startup.start = e_time_now();
+    server->startup.last_phase = server->startup.start;
+
+    wl_signal_init(&server->events.ready);
+
     //handles accepting clients from Unix socket, managing wl globals, ...
     e_log_info("creating display...");
     server->display = wl_display_create();
@@ -183,8 +319,19 @@ int e_server_init(struct e_server* server, struct e_config* config)
     //handle event source signals
     server->sources.sigint = wl_event_loop_add_signal(server->event_loop, SIGINT, e_server_handle_signal_terminate, server);
     server->sources.sigterm = wl_event_loop_add_signal(server->event_loop, SIGTERM, e_server_handle_signal_terminate, server);
+#if E_TRACE
+    server->sources.sigusr1 = wl_event_loop_add_signal(server->event_loop, SIGUSR1, e_server_handle_signal_trace_export, server);
+#endif
+    server->sources.sigusr2 = wl_event_loop_add_signal(server->event_loop, SIGUSR2, e_server_handle_signal_log_clients, server);
     //TODO: sighup & sigchld?
 
+    server->thread_pool = e_thread_pool_create(server->event_loop, WORKER_THREAD_COUNT);
+
+    if (server->thread_pool == NULL)
+        e_log_error("e_server_init: failed to create thread pool, blocking work will run on the event loop");
+
+    e_server_startup_phase(server, "display");
+
     //according to wayfire (who discovered this), for this to work inside of gtk apps this must be one of the first globals
     //I read this inside labwc
     //Allows a shortcut for pasting text, usually middle click
@@ -206,6 +353,8 @@ int e_server_init(struct e_server* server, struct e_config* config)
     //backend events
     SIGNAL_CONNECT(server->backend->events.new_input, server->new_input, e_server_new_input);
 
+    e_server_startup_phase(server, "backend");
+
     //renderer handles rendering
     e_log_info("creating renderer...");
     server->renderer = wlr_renderer_autocreate(server->backend);
@@ -220,6 +369,8 @@ int e_server_init(struct e_server* server, struct e_config* config)
     
     SIGNAL_CONNECT(server->renderer->events.lost, server->renderer_lost, e_server_renderer_lost);
 
+    e_server_startup_phase(server, "renderer");
+
     struct wlr_linux_dmabuf_v1* linux_dmabuf = NULL;
 
     if (wlr_renderer_get_texture_formats(server->renderer, WLR_BUFFER_CAP_DMABUF) != NULL)
@@ -245,6 +396,8 @@ int e_server_init(struct e_server* server, struct e_config* config)
             e_log_error("e_server_init: server has support for explicit synchronization, but failed to create wlr_linux_drm_syncobj_manager_v1");
     }
 
+    e_server_startup_phase(server, "dmabuf & syncobj");
+
     //allocates memory for pixel buffers 
     server->allocator = wlr_allocator_autocreate(server->backend, server->renderer);
 
@@ -265,9 +418,16 @@ int e_server_init(struct e_server* server, struct e_config* config)
     
     //TODO: log more errors here
 
-    //allows clients to control selection and take the role of a clipboard manager
-    wlr_data_control_manager_v1_create(server->display);
-    wlr_ext_data_control_manager_v1_create(server->display, E_EXT_DATA_CONTROL_V1_VERSION);
+    //before any client connects, so every client and surface is counted
+    if (!e_server_init_clients(server))
+    {
+        e_log_error("e_server_init: failed to init client tracking");
+        return 1;
+    }
+
+    //data control is created after the first frame, see server_init_deferred
+
+    e_server_startup_phase(server, "allocator & compositor");
 
     if (!e_server_init_outputs(server))
     {
@@ -281,6 +441,8 @@ int e_server_init(struct e_server* server, struct e_config* config)
         return 1;
     }
 
+    e_server_startup_phase(server, "outputs & scene");
+
     if (linux_dmabuf != NULL)
         wlr_scene_set_linux_dmabuf_v1(server->scene, linux_dmabuf);
 
@@ -293,6 +455,8 @@ int e_server_init(struct e_server* server, struct e_config* config)
         return 1;
     }
 
+    e_server_startup_phase(server, "seat");
+
     //xdg shell v6, protocol for application views
     if (!e_server_init_xdg_shell(server))
     {
@@ -307,6 +471,14 @@ int e_server_init(struct e_server* server, struct e_config* config)
         return 1;
     }
 
+    if (!e_server_init_views(server))
+    {
+        e_log_error("e_server_init: failed to init views");
+        return 1;
+    }
+
+    e_server_startup_phase(server, "shells");
+
     #if E_XWAYLAND_SUPPORT
     //create & start xwayland server, xwayland shell protocol
     if (!e_server_init_xwayland(server, server->seat, server->config->xwayland_lazy))
@@ -314,6 +486,8 @@ int e_server_init(struct e_server* server, struct e_config* config)
         e_log_error("e_server_init: failed to init xwayland");
         return 1;
     }
+
+    e_server_startup_phase(server, "xwayland");
     #endif
 
     //protocol to describe output regions
@@ -325,6 +499,11 @@ int e_server_init(struct e_server* server, struct e_config* config)
 
     if (viewporter == NULL)
         e_log_error("e_server_init: failed to create wlr_viewporter");
+
+    //tells clients the exact scale of their outputs, so they render buffers at that size and set it with viewporter
+    //scene sends the scale when surfaces enter outputs
+    if (wlr_fractional_scale_manager_v1_create(server->display, E_FRACTIONAL_SCALE_VERSION) == NULL)
+        e_log_error("e_server_init: failed to create wlr_fractional_scale_manager_v1");
     
     if (wlr_presentation_create(server->display, server->backend, E_PRESENTATION_TIME_VERSION) == NULL)
         e_log_error("e_server_init: failed to create wlr_presentation");
@@ -377,10 +556,9 @@ int e_server_init(struct e_server* server, struct e_config* config)
         return 1;
     }
 
-    //allows clients to reference surfaces of other clients
-    struct wlr_xdg_foreign_registry* foreign_registry = wlr_xdg_foreign_registry_create(server->display);
-    wlr_xdg_foreign_v1_create(server->display, foreign_registry);
-    wlr_xdg_foreign_v2_create(server->display, foreign_registry);
+    //xdg foreign & output capturing are created after the first frame, see server_init_deferred
+
+    e_server_startup_phase(server, "protocols");
 
     return 0;
 }
@@ -419,6 +597,16 @@ bool e_server_start(struct e_server* server)
         return false;
     }
 
+    e_server_startup_phase(server, "backend start");
+
+    //don't wait forever on a frame to create deferred globals, for example when there are no outputs
+    server->sources.deferred_timeout = wl_event_loop_add_timer(server->event_loop, server_handle_deferred_timeout, server);
+
+    if (server->sources.deferred_timeout != NULL)
+        wl_event_source_timer_update(server->sources.deferred_timeout, DEFERRED_GLOBALS_TIMEOUT_MS);
+    else
+        server_init_deferred(server);
+
     e_log_info("WAYLAND_DISPLAY=%s", socket);
 
     return true;
@@ -432,7 +620,38 @@ void e_server_run(struct e_server* server)
         return;
 
     e_log_info("running wl display...");
-    wl_display_run(server->display);
+
+    //same as wl_display_run, but times only dispatching of events & not waiting for them
+    int loop_fd = wl_event_loop_get_fd(server->event_loop);
+    server->running = true;
+
+    //reports hangs while they're happening, as a hung event loop never gets to log them itself
+    if (!e_watchdog_start())
+        e_log_error("e_server_run: no watchdog, event loop hangs are only logged once they end");
+
+    while (server->running)
+    {
+        e_watchdog_dispatch_begin();
+        wl_event_loop_dispatch(server->event_loop, 0);
+        e_watchdog_dispatch_end();
+
+        if (!server->running)
+            break;
+
+        wl_display_flush_clients(server->display);
+
+        struct pollfd loop_pollfd = { .fd = loop_fd, .events = POLLIN };
+
+        if (poll(&loop_pollfd, 1, -1) == -1 && errno != EINTR)
+        {
+            e_log_error("e_server_run: failed to poll event loop: %s", strerror(errno));
+            break;
+        }
+    }
+
+    e_watchdog_stop();
+
+    server->running = false;
 }
 
 void e_server_terminate(struct e_server* server)
@@ -443,6 +662,7 @@ void e_server_terminate(struct e_server* server)
         return;
 
     e_log_info("terminating server's wl display");
+    server->running = false;
     wl_display_terminate(server->display);
 }
 
@@ -459,6 +679,13 @@ void e_server_fini(struct e_server* server)
     //remove event source signals
     wl_event_source_remove(server->sources.sigint);
     wl_event_source_remove(server->sources.sigterm);
+#if E_TRACE
+    wl_event_source_remove(server->sources.sigusr1);
+#endif
+    wl_event_source_remove(server->sources.sigusr2);
+
+    if (server->sources.deferred_timeout != NULL)
+        wl_event_source_remove(server->sources.deferred_timeout);
 
 #if E_XWAYLAND_SUPPORT
     e_server_fini_xwayland(server);
@@ -467,7 +694,18 @@ void e_server_fini(struct e_server* server)
     wl_display_destroy_clients(server->display);
 
     e_seat_destroy(server->seat);
+
+    //finish remaining jobs while event loop still exists
+    e_thread_pool_destroy(server->thread_pool);
+    server->thread_pool = NULL;
+
+#if E_TRACE
+    //worker threads are joined, so their trace buffers can be freed too
+    e_trace_fini();
+#endif
     
+    e_server_fini_clients(server);
+    e_server_fini_views(server);
     e_server_fini_xdg_shell(server);
     e_server_fini_layer_shell(server);
 
@@ -12,12 +12,8 @@
 #include "util/log.h"
 
 //TODO: document config paths used in EstrogenWL
-//TODO: move get_config_path & get_relative_config_path
 //FIXME: possibility of two forward slashes next to eachother in file paths, might cause issues later?
 
-// Buffer size for config paths (env, autostart, ...)
-#define CONFIG_PATHS_MAX_SIZE 1024
-
 #define ENV_LINE_MAX_SIZE 1024
 
 #define SHELL_PATH "/bin/sh"
@@ -54,7 +50,7 @@ static bool e_str_is_empty_or_null(const char* string)
 
 // Outs path to EstrogenWL's config directory with a null-terminator.
 // Returns length of path (as if weren't truncated).
-static size_t get_config_path(char* buffer, size_t maxlen)
+size_t e_session_get_config_path(char* buffer, size_t maxlen)
 {
     if (buffer == NULL)
         return 0;
@@ -79,12 +75,12 @@ static size_t get_config_path(char* buffer, size_t maxlen)
 
 // Outs full path using file path relative to config path into buffer with a null-terminator.
 // Returns length of path (as if weren't truncated).
-static size_t get_relative_config_path(char* buffer, size_t maxlen, const char* path)
+size_t e_session_get_relative_config_path(char* buffer, size_t maxlen, const char* path)
 {
     if (buffer == NULL || path == NULL)
         return 0;
 
-    size_t length = get_config_path(buffer, maxlen);
+    size_t length = e_session_get_config_path(buffer, maxlen);
 
     if (length >= maxlen)
         return length;
@@ -147,13 +143,13 @@ static bool process_env_line_status_is_error(enum process_env_line_status status
 // Format: (name)=(value)
 bool e_session_init_env(void)
 {
-    char env_path[CONFIG_PATHS_MAX_SIZE];
-    size_t env_path_length = get_relative_config_path(env_path, CONFIG_PATHS_MAX_SIZE - 1, "environment");
+    char env_path[E_CONFIG_PATHS_MAX_SIZE];
+    size_t env_path_length = e_session_get_relative_config_path(env_path, E_CONFIG_PATHS_MAX_SIZE - 1, "environment");
 
     //path too long
-    if (env_path_length >= CONFIG_PATHS_MAX_SIZE)
+    if (env_path_length >= E_CONFIG_PATHS_MAX_SIZE)
     {
-        e_log_error("e_session_init_env: environment file path name is longer than %i characters. (%s, %i)", CONFIG_PATHS_MAX_SIZE - 1, env_path, env_path_length);
+        e_log_error("e_session_init_env: environment file path name is longer than %i characters. (%s, %i)", E_CONFIG_PATHS_MAX_SIZE - 1, env_path, env_path_length);
         return false;
     }
 
@@ -202,13 +198,13 @@ bool e_session_init_env(void)
 // Returns true if fork (duplicating process) was successful, otherwise false.
 bool e_session_autostart_run(void)
 {
-    char autostart_path[CONFIG_PATHS_MAX_SIZE];
-    size_t autostart_path_length = get_relative_config_path(autostart_path, CONFIG_PATHS_MAX_SIZE - 1, "autostart.sh");
+    char autostart_path[E_CONFIG_PATHS_MAX_SIZE];
+    size_t autostart_path_length = e_session_get_relative_config_path(autostart_path, E_CONFIG_PATHS_MAX_SIZE - 1, "autostart.sh");
 
     //path too long
-    if (autostart_path_length >= CONFIG_PATHS_MAX_SIZE)
+    if (autostart_path_length >= E_CONFIG_PATHS_MAX_SIZE)
     {
-        e_log_error("e_session_autostart_run: autostart.sh file path name is longer than %i characters. (%s, %i)", CONFIG_PATHS_MAX_SIZE - 1, autostart_path, autostart_path_length);
+        e_log_error("e_session_autostart_run: autostart.sh file path name is longer than %i characters. (%s, %i)", E_CONFIG_PATHS_MAX_SIZE - 1, autostart_path, autostart_path_length);
         return false;
     }
 
@@ -0,0 +1,259 @@
+#include "util/thread_pool.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <sys/eventfd.h>
+
+#include <wayland-server-core.h>
+#include <wayland-util.h>
+
+#include "util/log.h"
+#include "util/wl_macros.h"
+
+struct thread_job
+{
+    e_thread_job_work_func_t work;
+    e_thread_job_done_func_t done;
+    void* data;
+
+    struct wl_list link;
+};
+
+struct e_thread_pool
+{
+    pthread_t* threads;
+    int thread_count;
+
+    // guards queued, completed & stopping
+    pthread_mutex_t mutex;
+    // signalled when a job is queued or pool is stopping
+    pthread_cond_t job_queued;
+
+    struct wl_list queued; //struct thread_job*
+    struct wl_list completed; //struct thread_job*
+
+    // workers exit once queue is empty
+    bool stopping;
+
+    // written by workers when a job completes
+    int completed_fd;
+    struct wl_event_source* completed_source;
+};
+
+static void* thread_pool_worker(void* data)
+{
+    struct e_thread_pool* pool = data;
+
+    pthread_mutex_lock(&pool->mutex);
+
+    while (true)
+    {
+        while (wl_list_empty(&pool->queued) && !pool->stopping)
+            pthread_cond_wait(&pool->job_queued, &pool->mutex);
+
+        if (wl_list_empty(&pool->queued))
+            break;
+
+        struct thread_job* job = wl_container_of(pool->queued.next, job, link);
+        wl_list_remove(&job->link);
+
+        pthread_mutex_unlock(&pool->mutex);
+
+        job->work(job->data);
+
+        pthread_mutex_lock(&pool->mutex);
+
+        wl_list_append(pool->completed, &job->link);
+
+        //wake event loop, value of eventfd is just a counter
+        uint64_t one = 1;
+        while (write(pool->completed_fd, &one, sizeof(one)) == -1 && errno == EINTR)
+            ;
+    }
+
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+// Call done callbacks of completed jobs & free them.
+static void thread_pool_finish_completed(struct e_thread_pool* pool)
+{
+    struct wl_list completed;
+    wl_list_init(&completed);
+
+    //take completed jobs, so done callbacks can submit new jobs
+    pthread_mutex_lock(&pool->mutex);
+    wl_list_insert_list(&completed, &pool->completed);
+    wl_list_init(&pool->completed);
+    pthread_mutex_unlock(&pool->mutex);
+
+    struct thread_job* job;
+    struct thread_job* tmp;
+    wl_list_for_each_safe(job, tmp, &completed, link)
+    {
+        wl_list_remove(&job->link);
+
+        if (job->done != NULL)
+            job->done(job->data);
+
+        free(job);
+    }
+}
+
+static int thread_pool_handle_completed(int fd, uint32_t mask, void* data)
+{
+    struct e_thread_pool* pool = data;
+
+    uint64_t count;
+    if (read(fd, &count, sizeof(count)) == -1 && errno != EAGAIN)
+        e_log_error("thread_pool_handle_completed: failed to read eventfd");
+
+    thread_pool_finish_completed(pool);
+
+    return 0;
+}
+
+// Stops & joins the first thread_count worker threads.
+static void thread_pool_join(struct e_thread_pool* pool, int thread_count)
+{
+    pthread_mutex_lock(&pool->mutex);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->job_queued);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (int i = 0; i < thread_count; i++)
+        pthread_join(pool->threads[i], NULL);
+}
+
+// Creates a pool of thread_count worker threads, that completes jobs on event loop.
+// Returns NULL on fail.
+struct e_thread_pool* e_thread_pool_create(struct wl_event_loop* event_loop, int thread_count)
+{
+    assert(event_loop && thread_count > 0);
+
+    struct e_thread_pool* pool = calloc(1, sizeof(*pool));
+
+    if (pool == NULL)
+    {
+        e_log_error("e_thread_pool_create: failed to allocate pool");
+        return NULL;
+    }
+
+    pool->threads = calloc(thread_count, sizeof(*pool->threads));
+
+    if (pool->threads == NULL)
+    {
+        e_log_error("e_thread_pool_create: failed to allocate threads");
+        free(pool);
+        return NULL;
+    }
+
+    pool->completed_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    if (pool->completed_fd == -1)
+    {
+        e_log_error("e_thread_pool_create: failed to create eventfd");
+        free(pool->threads);
+        free(pool);
+        return NULL;
+    }
+
+    pool->completed_source = wl_event_loop_add_fd(event_loop, pool->completed_fd, WL_EVENT_READABLE, thread_pool_handle_completed, pool);
+
+    if (pool->completed_source == NULL)
+    {
+        e_log_error("e_thread_pool_create: failed to add eventfd to event loop");
+        close(pool->completed_fd);
+        free(pool->threads);
+        free(pool);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->job_queued, NULL);
+
+    wl_list_init(&pool->queued);
+    wl_list_init(&pool->completed);
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        if (pthread_create(&pool->threads[i], NULL, thread_pool_worker, pool) != 0)
+        {
+            e_log_error("e_thread_pool_create: failed to create worker thread");
+
+            pool->thread_count = i;
+            e_thread_pool_destroy(pool);
+            return NULL;
+        }
+    }
+
+    pool->thread_count = thread_count;
+
+    return pool;
+}
+
+// Queues work to be run on a worker thread, done is called on the event loop's thread after.
+// Done is allowed to be NULL.
+// Returns true on success, false on fail.
+bool e_thread_pool_submit(struct e_thread_pool* pool, e_thread_job_work_func_t work, e_thread_job_done_func_t done, void* data)
+{
+    assert(pool && work);
+
+    if (pool == NULL || work == NULL)
+        return false;
+
+    struct thread_job* job = calloc(1, sizeof(*job));
+
+    if (job == NULL)
+    {
+        e_log_error("e_thread_pool_submit: failed to allocate job");
+        return false;
+    }
+
+    job->work = work;
+    job->done = done;
+    job->data = data;
+
+    pthread_mutex_lock(&pool->mutex);
+    wl_list_append(pool->queued, &job->link);
+    pthread_cond_signal(&pool->job_queued);
+    pthread_mutex_unlock(&pool->mutex);
+
+    return true;
+}
+
+// Finishes all queued jobs, then destroys pool.
+void e_thread_pool_destroy(struct e_thread_pool* pool)
+{
+    if (pool == NULL)
+        return;
+
+    //workers run the remaining queue before exiting
+    thread_pool_join(pool, pool->thread_count);
+
+    //no workers left to run them if none could be created
+    struct thread_job* job;
+    wl_list_for_each(job, &pool->queued, link)
+        job->work(job->data);
+
+    wl_list_insert_list(pool->completed.prev, &pool->queued);
+    wl_list_init(&pool->queued);
+
+    thread_pool_finish_completed(pool);
+
+    wl_event_source_remove(pool->completed_source);
+    close(pool->completed_fd);
+
+    pthread_cond_destroy(&pool->job_queued);
+    pthread_mutex_destroy(&pool->mutex);
+
+    free(pool->threads);
+    free(pool);
+}
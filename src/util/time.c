@@ -0,0 +1,16 @@
+#include "util/time.h"
+
+#include <time.h>
+
+struct timespec e_time_now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now;
+}
+
+double e_time_diff_ms(const struct timespec* start, const struct timespec* end)
+{
+    return (end->tv_sec - start->tv_sec) * 1000.0 + (end->tv_nsec - start->tv_nsec) / 1000000.0;
+}
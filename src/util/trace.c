@@ -0,0 +1,236 @@
+#include "util/trace.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "util/log.h"
+
+// Complete event, a span with start & duration.
+struct trace_event
+{
+    const char* name;
+    // monotonic time in microseconds
+    uint64_t start_us;
+    uint64_t duration_us;
+};
+
+struct trace_span
+{
+    const char* name;
+    uint64_t start_us;
+};
+
+struct trace_buffer
+{
+    // id of thread shown in trace
+    int tid;
+
+    // guards events & count against exporting from another thread
+    pthread_mutex_t mutex;
+
+    struct trace_event events[E_TRACE_BUFFER_SIZE];
+    // total amount of recorded events, may be larger than E_TRACE_BUFFER_SIZE
+    uint64_t count;
+
+    struct trace_span spans[E_TRACE_MAX_DEPTH];
+    // may be larger than E_TRACE_MAX_DEPTH, untracked spans are ignored
+    int depth;
+
+    // next buffer in list of all threads' buffers
+    struct trace_buffer* next;
+};
+
+// allocated on first use by each thread
+static _Thread_local struct trace_buffer* thread_buffer = NULL;
+
+// buffers of all threads that traced, so they can be exported & freed from any thread
+static struct trace_buffer* buffers = NULL;
+static pthread_mutex_t buffers_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static atomic_int next_tid = 1;
+
+static uint64_t trace_now_us(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+}
+
+// Returns NULL on fail.
+static struct trace_buffer* trace_get_buffer(void)
+{
+    if (thread_buffer != NULL)
+        return thread_buffer;
+
+    thread_buffer = calloc(1, sizeof(*thread_buffer));
+
+    if (thread_buffer == NULL)
+    {
+        e_log_error("trace_get_buffer: failed to allocate trace buffer");
+        return NULL;
+    }
+
+    thread_buffer->tid = atomic_fetch_add(&next_tid, 1);
+    pthread_mutex_init(&thread_buffer->mutex, NULL);
+
+    pthread_mutex_lock(&buffers_mutex);
+    thread_buffer->next = buffers;
+    buffers = thread_buffer;
+    pthread_mutex_unlock(&buffers_mutex);
+
+    return thread_buffer;
+}
+
+// Starts a named span on the calling thread, spans may be nested.
+// Name is written into the exported JSON as is, so it must be a string literal without quotes or backslashes.
+void e_trace_begin(const char* name)
+{
+    struct trace_buffer* buffer = trace_get_buffer();
+
+    if (buffer == NULL)
+        return;
+
+    if (buffer->depth < E_TRACE_MAX_DEPTH)
+        buffer->spans[buffer->depth] = (struct trace_span){ .name = name, .start_us = trace_now_us() };
+
+    buffer->depth++;
+}
+
+// Ends the last begun span on the calling thread.
+void e_trace_end(void)
+{
+    struct trace_buffer* buffer = thread_buffer;
+
+    if (buffer == NULL || buffer->depth <= 0)
+    {
+        e_log_error("e_trace_end: no span to end");
+        return;
+    }
+
+    buffer->depth--;
+
+    if (buffer->depth >= E_TRACE_MAX_DEPTH)
+        return;
+
+    struct trace_span* span = &buffer->spans[buffer->depth];
+    uint64_t end_us = trace_now_us();
+
+    //uncontended unless events are being exported
+    pthread_mutex_lock(&buffer->mutex);
+
+    struct trace_event* event = &buffer->events[buffer->count % E_TRACE_BUFFER_SIZE];
+    event->name = span->name;
+    event->start_us = span->start_us;
+    event->duration_us = end_us - span->start_us;
+
+    buffer->count++;
+
+    pthread_mutex_unlock(&buffer->mutex);
+}
+
+// Writes events of buffer as JSON array elements.
+// Returns amount of events written.
+static uint64_t trace_write_buffer(FILE* file, struct trace_buffer* buffer, int pid, bool* first_event)
+{
+    pthread_mutex_lock(&buffer->mutex);
+
+    //oldest event still in buffer
+    uint64_t first = (buffer->count > E_TRACE_BUFFER_SIZE) ? buffer->count - E_TRACE_BUFFER_SIZE : 0;
+
+    for (uint64_t i = first; i < buffer->count; i++)
+    {
+        struct trace_event* event = &buffer->events[i % E_TRACE_BUFFER_SIZE];
+
+        fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":%i,\"tid\":%i}", *first_event ? "" : ",",
+            event->name, (unsigned long long)event->start_us, (unsigned long long)event->duration_us, pid, buffer->tid);
+
+        *first_event = false;
+    }
+
+    uint64_t written = buffer->count - first;
+
+    pthread_mutex_unlock(&buffer->mutex);
+
+    return written;
+}
+
+// Writes events recorded by all threads as Chrome trace JSON to file at path.
+// Returns true on success, false on fail.
+bool e_trace_export(const char* path)
+{
+    pthread_mutex_lock(&buffers_mutex);
+
+    if (buffers == NULL)
+    {
+        pthread_mutex_unlock(&buffers_mutex);
+        e_log_error("e_trace_export: nothing was traced");
+        return false;
+    }
+
+    FILE* file = fopen(path, "w");
+
+    if (file == NULL)
+    {
+        pthread_mutex_unlock(&buffers_mutex);
+        e_log_error("e_trace_export: failed to open %s", path);
+        return false;
+    }
+
+    int pid = (int)getpid();
+    bool first_event = true;
+    uint64_t written = 0;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    for (struct trace_buffer* buffer = buffers; buffer != NULL; buffer = buffer->next)
+        written += trace_write_buffer(file, buffer, pid, &first_event);
+
+    pthread_mutex_unlock(&buffers_mutex);
+
+    fprintf(file, "\n]}\n");
+
+    bool success = (ferror(file) == 0);
+
+    if (fclose(file) != 0)
+        success = false;
+
+    if (success)
+        e_log_info("exported %llu trace events to %s", (unsigned long long)written, path);
+    else
+        e_log_error("e_trace_export: failed to write %s", path);
+
+    return success;
+}
+
+// Frees buffers of all threads.
+// No other thread may trace anymore once this is called.
+void e_trace_fini(void)
+{
+    pthread_mutex_lock(&buffers_mutex);
+
+    struct trace_buffer* buffer = buffers;
+
+    while (buffer != NULL)
+    {
+        struct trace_buffer* next = buffer->next;
+
+        pthread_mutex_destroy(&buffer->mutex);
+        free(buffer);
+
+        buffer = next;
+    }
+
+    buffers = NULL;
+
+    pthread_mutex_unlock(&buffers_mutex);
+
+    thread_buffer = NULL;
+}
@@ -0,0 +1,322 @@
+#include "util/watchdog.h"
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <errno.h>
+
+#include <pthread.h>
+#include <unistd.h>
+
+#if E_HAVE_EXECINFO
+#include <execinfo.h>
+#endif
+
+#include "util/log.h"
+#include "util/time.h"
+#include "util/trace.h"
+
+struct watchdog_section
+{
+    const char* name;
+    struct timespec start;
+};
+
+static struct
+{
+    bool dispatching;
+    struct timespec dispatch_start;
+
+    struct watchdog_section sections[E_WATCHDOG_MAX_DEPTH];
+    // may be larger than E_WATCHDOG_MAX_DEPTH, untracked sections are ignored
+    int depth;
+
+    // slowest section of current dispatch
+    const char* slowest_name;
+    // section slowest section was nested in, NULL if none
+    const char* slowest_parent;
+    double slowest_ms;
+} watchdog = {0};
+
+// Interval at which watchdog thread checks the event loop.
+#define MONITOR_INTERVAL_MS (E_WATCHDOG_HANG_MS / 4)
+
+// Max amount of frames in backtrace of a hung event loop thread.
+#define MONITOR_BACKTRACE_FRAMES 64
+
+// Shared between event loop thread and watchdog thread.
+static struct
+{
+    bool started;
+
+    pthread_t thread;
+    pthread_t loop_thread;
+    // backtrace signal handler is installed, signal would terminate process otherwise
+    bool backtrace_handler;
+
+    // guards stop, signals watchdog thread to stop waiting
+    pthread_mutex_t mutex;
+    pthread_cond_t stop_cond;
+    bool stop;
+
+    // incremented when a dispatch begins & ends, odd while dispatching
+    atomic_uint heartbeat;
+    // innermost section being run, NULL if none
+    _Atomic(const char*) section;
+} monitor = {0};
+
+// Writes message without stdio or allocating, safe from a signal handler.
+static void monitor_write(const char* message, size_t length)
+{
+    ssize_t written = write(STDERR_FILENO, message, length);
+    (void)written;
+}
+
+#if E_HAVE_EXECINFO
+// Prints backtrace of event loop thread, sent to it by watchdog thread.
+static void monitor_handle_backtrace_signal(int signal)
+{
+    static const char header[] = "watchdog: backtrace of event loop thread:\n";
+    monitor_write(header, sizeof(header) - 1);
+
+    void* frames[MONITOR_BACKTRACE_FRAMES];
+    int count = backtrace(frames, MONITOR_BACKTRACE_FRAMES);
+
+    backtrace_symbols_fd(frames, count, STDERR_FILENO);
+}
+#endif
+
+static void monitor_report_hang(double hang_ms)
+{
+    const char* section = atomic_load(&monitor.section);
+
+    char message[256];
+    int length = snprintf(message, sizeof(message), "watchdog: event loop hung for %.0f ms, current section: %s\n", hang_ms, (section != NULL) ? section : "(none)");
+
+    if (length > 0)
+        monitor_write(message, ((size_t)length < sizeof(message)) ? (size_t)length : sizeof(message) - 1);
+
+    #if E_HAVE_EXECINFO
+    if (monitor.backtrace_handler)
+        pthread_kill(monitor.loop_thread, SIGRTMIN);
+    #endif
+}
+
+// Watchdog thread, checks heartbeat of event loop until stopped.
+static void* monitor_run(void* data)
+{
+    unsigned int last_heartbeat = 0;
+    unsigned int reported_heartbeat = 0;
+    struct timespec last_change = e_time_now();
+
+    pthread_mutex_lock(&monitor.mutex);
+
+    while (!monitor.stop)
+    {
+        struct timespec deadline = e_time_now();
+        deadline.tv_nsec += (long)MONITOR_INTERVAL_MS * 1000000;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000;
+        deadline.tv_nsec %= 1000000000;
+
+        pthread_cond_timedwait(&monitor.stop_cond, &monitor.mutex, &deadline);
+
+        if (monitor.stop)
+            break;
+
+        unsigned int heartbeat = atomic_load(&monitor.heartbeat);
+        struct timespec now = e_time_now();
+
+        if (heartbeat != last_heartbeat)
+        {
+            last_heartbeat = heartbeat;
+            last_change = now;
+            continue;
+        }
+
+        //same dispatch is still running, only report it once
+        double hang_ms = e_time_diff_ms(&last_change, &now);
+
+        if ((heartbeat & 1) && heartbeat != reported_heartbeat && hang_ms >= E_WATCHDOG_HANG_MS)
+        {
+            reported_heartbeat = heartbeat;
+            monitor_report_hang(hang_ms);
+        }
+    }
+
+    pthread_mutex_unlock(&monitor.mutex);
+
+    return NULL;
+}
+
+// Starts watchdog thread, which reports hangs of the event loop with the current section and a backtrace of the event loop thread.
+// Must be called from the event loop thread.
+// Returns true on success, false on fail.
+bool e_watchdog_start(void)
+{
+    if (monitor.started)
+        return true;
+
+    monitor.loop_thread = pthread_self();
+    monitor.stop = false;
+    monitor.backtrace_handler = false;
+
+    #if E_HAVE_EXECINFO
+    //backtrace loads its unwinder on first use, which allocates, so don't let that happen in the signal handler
+    void* frames[1];
+    backtrace(frames, 1);
+
+    struct sigaction action = {0};
+    action.sa_handler = monitor_handle_backtrace_signal;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+
+    if (sigaction(SIGRTMIN, &action, NULL) == 0)
+        monitor.backtrace_handler = true;
+    else
+        e_log_error("e_watchdog_start: failed to set backtrace signal handler, hangs are reported without backtrace");
+    #endif
+
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    //e_time_now is monotonic
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+
+    pthread_mutex_init(&monitor.mutex, NULL);
+    pthread_cond_init(&monitor.stop_cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+
+    int error = pthread_create(&monitor.thread, NULL, monitor_run, NULL);
+
+    if (error != 0)
+    {
+        e_log_error("e_watchdog_start: failed to create watchdog thread: %s", strerror(error));
+        pthread_cond_destroy(&monitor.stop_cond);
+        pthread_mutex_destroy(&monitor.mutex);
+        return false;
+    }
+
+    monitor.started = true;
+
+    return true;
+}
+
+// Stops watchdog thread.
+void e_watchdog_stop(void)
+{
+    if (!monitor.started)
+        return;
+
+    pthread_mutex_lock(&monitor.mutex);
+    monitor.stop = true;
+    pthread_cond_signal(&monitor.stop_cond);
+    pthread_mutex_unlock(&monitor.mutex);
+
+    pthread_join(monitor.thread, NULL);
+
+    pthread_cond_destroy(&monitor.stop_cond);
+    pthread_mutex_destroy(&monitor.mutex);
+
+    monitor.started = false;
+}
+
+// Starts timing a dispatch of the event loop.
+void e_watchdog_dispatch_begin(void)
+{
+    watchdog.dispatching = true;
+    watchdog.dispatch_start = e_time_now();
+
+    //odd, dispatching
+    atomic_fetch_add(&monitor.heartbeat, 1);
+
+    watchdog.depth = 0;
+    watchdog.slowest_name = NULL;
+    watchdog.slowest_parent = NULL;
+    watchdog.slowest_ms = 0.0;
+}
+
+// Stops timing the current dispatch of the event loop, logs it if it stalled with its slowest section.
+void e_watchdog_dispatch_end(void)
+{
+    if (!watchdog.dispatching)
+        return;
+
+    watchdog.dispatching = false;
+
+    //even, waiting for events
+    atomic_fetch_add(&monitor.heartbeat, 1);
+    atomic_store(&monitor.section, NULL);
+
+    struct timespec now = e_time_now();
+    double dispatch_ms = e_time_diff_ms(&watchdog.dispatch_start, &now);
+
+    if (watchdog.depth != 0)
+        e_log_error("e_watchdog_dispatch_end: %i sections weren't ended", watchdog.depth);
+
+    if (dispatch_ms < E_WATCHDOG_STALL_MS)
+        return;
+
+    if (watchdog.slowest_name == NULL)
+        e_log_error("event loop stalled for %.1f ms, no section was timed", dispatch_ms);
+    else if (watchdog.slowest_parent == NULL)
+        e_log_error("event loop stalled for %.1f ms, slowest section: %s (%.1f ms)", dispatch_ms, watchdog.slowest_name, watchdog.slowest_ms);
+    else
+        e_log_error("event loop stalled for %.1f ms, slowest section: %s in %s (%.1f ms)", dispatch_ms, watchdog.slowest_name, watchdog.slowest_parent, watchdog.slowest_ms);
+}
+
+// Starts timing a named section of work, sections may be nested.
+// Name must stay valid until the dispatch ends, use string literals.
+void e_watchdog_section_begin(const char* name)
+{
+    //sections double as tracepoints
+    E_TRACE_BEGIN(name);
+
+    if (watchdog.depth < E_WATCHDOG_MAX_DEPTH)
+    {
+        watchdog.sections[watchdog.depth].name = name;
+        watchdog.sections[watchdog.depth].start = e_time_now();
+    }
+
+    atomic_store(&monitor.section, name);
+
+    watchdog.depth++;
+}
+
+// Stops timing the last begun section.
+void e_watchdog_section_end(void)
+{
+    if (watchdog.depth <= 0)
+    {
+        e_log_error("e_watchdog_section_end: no section to end");
+        return;
+    }
+
+    E_TRACE_END();
+
+    watchdog.depth--;
+
+    //back in section this one was nested in, unknown if that one wasn't tracked
+    if (watchdog.depth > 0 && watchdog.depth <= E_WATCHDOG_MAX_DEPTH)
+        atomic_store(&monitor.section, watchdog.sections[watchdog.depth - 1].name);
+    else
+        atomic_store(&monitor.section, NULL);
+
+    if (watchdog.depth >= E_WATCHDOG_MAX_DEPTH)
+        return;
+
+    struct watchdog_section* section = &watchdog.sections[watchdog.depth];
+
+    struct timespec now = e_time_now();
+    double section_ms = e_time_diff_ms(&section->start, &now);
+
+    //sections ending outside of a dispatch (startup, shutdown) are never reported
+    if (section_ms > watchdog.slowest_ms)
+    {
+        watchdog.slowest_name = section->name;
+        watchdog.slowest_parent = (watchdog.depth > 0) ? watchdog.sections[watchdog.depth - 1].name : NULL;
+        watchdog.slowest_ms = section_ms;
+    }
+}